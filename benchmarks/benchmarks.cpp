@@ -0,0 +1,640 @@
+// File: benchmarks.cpp  Google benchmark suite for products, matrix*vector, elementwise ops, transposes, fills and blas.
+#include "matrix23/matrix.hpp"
+#include "matrix23/blas.hpp"
+#include "matrix23/batched.hpp"
+#include "matrix23/lu.hpp"
+#include "matrix23/cholesky.hpp"
+#include <benchmark/benchmark.h>
+
+//
+//  Every benchmark reports FLOP/s and bytes_per_second.  Only useful flops are counted, i.e. the definite
+//  zeros of triangular, band and diagonal shapes are left out, so packings can be compared directly.
+//  Bytes are the stored elements read plus written.  For regression tracking between releases run
+//      BMmatrix23 --benchmark_out=matrix23_benchmarks.json --benchmark_out_format=json
+//  or build the benchmark_json target which does just that.
+//
+using namespace matrix23;
+using T=double;
+
+using FCM=FullMatrixCM<T>;
+using FRM=FullMatrixRM<T>;
+using UCM=UpperTriangularMatrixCM<T>;
+using URM=UpperTriangularMatrixRM<T>;
+using LCM=LowerTriangularMatrixCM<T>;
+using LRM=LowerTriangularMatrixRM<T>;
+using UFCM=UpperTriangularMatrixFCM<T>;
+using D=DiagonalMatrix<T>;
+using SB=SBandMatrix<T>;
+using S=SymmetricMatrixCM<T>;
+
+constexpr size_t k_band=5; //Bandwidth for all SBand benchmarks.
+
+// Random n x n matrix for any packing.
+template <class M> M make(size_t n, fill_t f=matrix23::random)
+{
+    if constexpr (std::same_as<M,SB>)
+        return M(n,k_band,f);
+    else
+        return M(n,n,f);
+}
+
+// # of elements inside the shape of m.
+template <isMatrix M> double nonzeros(const M& m)
+{
+    double n=0;
+    for (size_t i=0;i<m.nr();i++) n+=m.shaper().nonzero_col_indexes(i).size();
+    return n;
+}
+// 2 * # of multiply-adds where both A(i,l) and B(l,j) are inside their shapes.
+template <isMatrix Ma, isMatrix Mb> double product_flops(const Ma& a, const Mb& b)
+{
+    double n=0;
+    auto sa=a.shaper();
+    auto sb=b.shaper();
+    for (size_t i=0;i<a.nr();i++)
+    {
+        auto ls=sa.nonzero_col_indexes(i);
+        if (ls.empty()) continue;
+        for (size_t j=0;j<b.nc();j++)
+        {
+            auto ks=sb.nonzero_row_indexes(j);
+            if (ks.empty()) continue;
+            size_t l0=std::max(ls.front(),ks.front()), l1=std::min(ls.back(),ks.back());
+            if (l0<=l1) n+=l1-l0+1;
+        }
+    }
+    return 2*n;
+}
+
+// Call after the timing loop.  flops and bytes are per iteration.
+void set_rates(benchmark::State& state, double flops, double bytes)
+{
+    if (flops>0) state.counters["FLOP/s"]=benchmark::Counter(flops,benchmark::Counter::kIsIterationInvariantRate);
+    state.SetBytesProcessed(int64_t(bytes*state.iterations()));
+}
+
+//
+//  Matrix*Matrix, C is constructed from the lazy product just like user code would do.
+//
+template <class Ma, class Mb, class Mc> void BM_Product(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    Ma A=make<Ma>(n);
+    Mb B=make<Mb>(n);
+    for (auto _:state)
+    {
+        Mc C=A*B;
+        benchmark::DoNotOptimize(C);
+        benchmark::ClobberMemory();
+    }
+    double nc=(A*B).packer().stored_size();
+    set_rates(state,product_flops(A,B),(A.size()+B.size()+nc)*sizeof(T));
+}
+// Kernels that skip the generic view.
+BENCHMARK_TEMPLATE(BM_Product,FCM ,FCM ,FCM )->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,FCM ,FCM ,FRM )->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,UCM ,UCM ,UCM )->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,URM ,URM ,URM )->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,LCM ,LCM ,LCM )->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,UCM ,LCM ,FCM )->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,UFCM,UFCM,UFCM)->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,UCM ,FCM ,FCM )->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_Product,D   ,D   ,D   )->RangeMultiplier(4)->Range(64,1<<16);
+BENCHMARK_TEMPLATE(BM_Product,D   ,FCM ,FCM )->RangeMultiplier(2)->Range(64,2048);
+BENCHMARK_TEMPLATE(BM_Product,FRM ,D   ,FRM )->RangeMultiplier(2)->Range(64,2048);
+BENCHMARK_TEMPLATE(BM_Product,SB  ,SB  ,SB  )->RangeMultiplier(8)->Range(64,1<<18);
+BENCHMARK_TEMPLATE(BM_Product,SB  ,FCM ,FCM )->RangeMultiplier(2)->Range(64,1024);
+// Generic MatrixProductView, row/col intersections per element.
+BENCHMARK_TEMPLATE(BM_Product,FRM ,FRM ,FRM )->RangeMultiplier(2)->Range(32,256);
+BENCHMARK_TEMPLATE(BM_Product,S   ,S   ,FCM )->RangeMultiplier(2)->Range(32,256);
+BENCHMARK_TEMPLATE(BM_Product,S   ,FCM ,FCM )->RangeMultiplier(2)->Range(32,256);
+
+// A*~A only multiplies the upper triangle.  FLOP/s are counted as for the full A*B.
+template <class Mc> void BM_RankK(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(n);
+    for (auto _:state)
+    {
+        Mc C=A*~A;
+        benchmark::DoNotOptimize(C);
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*n*n*n,(A.size()+Mc(n).size())*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_RankK,FCM)->RangeMultiplier(2)->Range(64,1024);
+BENCHMARK_TEMPLATE(BM_RankK,S  )->RangeMultiplier(2)->Range(64,1024);
+
+// The hand coded copy/cache loop from matmul.hpp, as a baseline.
+void BM_ReferenceLoop(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(n), B=make<FCM>(n);
+    for (auto _:state)
+    {
+        FCM C(n,n);
+        for (size_t i=0;i<n;i++)
+        {
+            Vector<T> Ai=A.row(i);
+            for (size_t j=0;j<n;j++)
+            {
+                T t=0.0;
+                for (size_t k=0;k<n;k++)
+                    t+=Ai(k)*B(k,j);
+                C(i,j)=t;
+            }
+        }
+        benchmark::DoNotOptimize(C);
+    }
+    set_rates(state,2.0*n*n*n,3.0*n*n*sizeof(T));
+}
+BENCHMARK(BM_ReferenceLoop)->RangeMultiplier(2)->Range(64,512);
+
+//
+//  Matrix*Vector
+//
+template <class M> void BM_MatVec(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    M A=make<M>(n);
+    Vector<T> x(n,matrix23::random);
+    for (auto _:state)
+    {
+        Vector<T> y=A*x;
+        benchmark::DoNotOptimize(y);
+    }
+    set_rates(state,2*nonzeros(A),(A.size()+2*n)*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_MatVec,FCM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_MatVec,FRM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_MatVec,UCM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_MatVec,URM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_MatVec,LCM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_MatVec,D  )->RangeMultiplier(4)->Range(64,1<<16);
+BENCHMARK_TEMPLATE(BM_MatVec,SB )->RangeMultiplier(8)->Range(64,1<<18);
+BENCHMARK_TEMPLATE(BM_MatVec,S  )->RangeMultiplier(4)->Range(64,4096);
+
+//
+//  Elementwise A+B and A*scalar.
+//
+template <class M> void BM_Add(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    M A=make<M>(n), B=make<M>(n);
+    for (auto _:state)
+    {
+        M C=A+B;
+        benchmark::DoNotOptimize(C);
+    }
+    set_rates(state,nonzeros(A),3.0*A.size()*sizeof(T));
+}
+template <class M> void BM_Scale(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    M A=make<M>(n);
+    for (auto _:state)
+    {
+        M C=A*2.0;
+        benchmark::DoNotOptimize(C);
+    }
+    set_rates(state,nonzeros(A),2.0*A.size()*sizeof(T));
+}
+#define MATRIX23_ELEMENTWISE(BM) \
+    BENCHMARK_TEMPLATE(BM,FCM)->RangeMultiplier(4)->Range(64,2048); \
+    BENCHMARK_TEMPLATE(BM,FRM)->RangeMultiplier(4)->Range(64,2048); \
+    BENCHMARK_TEMPLATE(BM,UCM)->RangeMultiplier(4)->Range(64,2048); \
+    BENCHMARK_TEMPLATE(BM,URM)->RangeMultiplier(4)->Range(64,2048); \
+    BENCHMARK_TEMPLATE(BM,LCM)->RangeMultiplier(4)->Range(64,2048); \
+    BENCHMARK_TEMPLATE(BM,D  )->RangeMultiplier(4)->Range(64,1<<16); \
+    BENCHMARK_TEMPLATE(BM,SB )->RangeMultiplier(8)->Range(64,1<<18); \
+    BENCHMARK_TEMPLATE(BM,S  )->RangeMultiplier(4)->Range(64,2048);
+MATRIX23_ELEMENTWISE(BM_Add)
+MATRIX23_ELEMENTWISE(BM_Scale)
+
+//
+//  Small transforms, compile time sized vs dynamic.
+//
+template <size_t N> void BM_FixedProduct(benchmark::State& state)
+{
+    FixedMatrixCM<T,N> A(matrix23::random), B(matrix23::random);
+    for (auto _:state)
+    {
+        FixedMatrixCM<T,N> C=A*B;
+        benchmark::DoNotOptimize(C);
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*N*N*N,3.0*N*N*sizeof(T));
+}
+template <size_t N> void BM_DynamicProduct(benchmark::State& state)
+{
+    FCM A(N,N,matrix23::random), B(N,N,matrix23::random);
+    for (auto _:state)
+    {
+        FCM C=A*B;
+        benchmark::DoNotOptimize(C);
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*N*N*N,3.0*N*N*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_FixedProduct,3);
+BENCHMARK_TEMPLATE(BM_FixedProduct,4);
+BENCHMARK_TEMPLATE(BM_FixedProduct,6);
+BENCHMARK_TEMPLATE(BM_DynamicProduct,3);
+BENCHMARK_TEMPLATE(BM_DynamicProduct,4);
+BENCHMARK_TEMPLATE(BM_DynamicProduct,6);
+//
+//  Batches of small products: one C=A*B per matrix, gemm_batched on ranges, gemm on a MatrixBatch.
+//
+constexpr size_t batch_count=4096;
+void set_batch_rates(benchmark::State& state, size_t n)
+{
+    set_rates(state,2.0*n*n*n*batch_count,3.0*n*n*batch_count*sizeof(T));
+}
+void BM_BatchLoop(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    std::vector<FCM> A(batch_count,FCM(n,n,matrix23::random)), B=A, C=A;
+    for (auto _:state)
+        for (size_t b=0;b<batch_count;b++)
+        {
+            C[b]=A[b]*B[b];
+            benchmark::ClobberMemory();
+        }
+    set_batch_rates(state,n);
+}
+void BM_BatchRanges(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    std::vector<FCM> A(batch_count,FCM(n,n,matrix23::random)), B=A, C=A;
+    for (auto _:state)
+    {
+        gemm_batched(1.0,A,B,0.0,C);
+        benchmark::ClobberMemory();
+    }
+    set_batch_rates(state,n);
+}
+void BM_BatchCompact(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    MatrixBatch<T> A(n,n,batch_count,matrix23::random), B=A, C=A;
+    for (auto _:state)
+    {
+        gemm(1.0,A,B,0.0,C);
+        benchmark::ClobberMemory();
+    }
+    set_batch_rates(state,n);
+}
+BENCHMARK(BM_BatchLoop   )->Arg(8)->Arg(16)->Arg(32)->Arg(64)->UseRealTime();
+BENCHMARK(BM_BatchRanges )->Arg(8)->Arg(16)->Arg(32)->Arg(64)->UseRealTime();
+BENCHMARK(BM_BatchCompact)->Arg(8)->Arg(16)->Arg(32)->Arg(64)->UseRealTime();
+//
+//  Chain (n x n/16)*(n/16 x n)*(n x n/16)*(n/16 x n).  Ordered=false evaluates left to right through temporaries,
+//  Ordered=true lets the chain pick A*((B*C)*D), about 1/3 of the multiply-adds.  FLOP/s counts the left to right work.
+//
+template <bool Ordered> void BM_MatrixChain(benchmark::State& state)
+{
+    size_t n=state.range(0), k=n/16;
+    FCM A(n,k,matrix23::random), B(k,n,matrix23::random), C(n,k,matrix23::random), D(k,n,matrix23::random), R(n,n);
+    for (auto _:state)
+    {
+        if constexpr (Ordered)
+            R=A*B*C*D;
+        else
+        {
+            FCM AB=A*B;
+            FCM ABC=AB*C;
+            R=ABC*D;
+        }
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*3*n*n*k,0.0);
+}
+BENCHMARK_TEMPLATE(BM_MatrixChain,false)->RangeMultiplier(2)->Range(256,2048)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_MatrixChain,true )->RangeMultiplier(2)->Range(256,2048)->UseRealTime();
+//
+//  (A*B+C)*D with and without the MatrixCacheView on A*B+C.  Budget 0 evaluates every row of A*B+C
+//  again for each column of D.
+//
+template <bool Cache> void BM_NestedProduct(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(n), B=make<FCM>(n), C=make<FCM>(n), D=make<FCM>(n), R(n,n);
+    size_t old=set_cache_budget(Cache ? cache_budget() : 0);
+    for (auto _:state)
+    {
+        R=(A*B+C)*D;
+        benchmark::ClobberMemory();
+    }
+    set_cache_budget(old);
+    set_rates(state,2.0*2*n*n*n,0.0);
+}
+BENCHMARK_TEMPLATE(BM_NestedProduct,false)->RangeMultiplier(2)->Range(32,128)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_NestedProduct,true )->RangeMultiplier(2)->Range(32,128)->UseRealTime();
+//
+//  R=2*A+B-C/3.  Fused is one linear pass over the stored data.  The other has B in a padded matrix,
+//  so the layouts differ and every element goes through operator()(i,j).
+//
+template <bool Fused> void BM_Elementwise(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(n), B=make<FCM>(n), C=make<FCM>(n), R(n,n);
+    FCM Bp(FullPackerCM(n,n,Fused ? n : n+8),zero);
+    Bp=B;
+    for (auto _:state)
+    {
+        R=2.0*A+Bp-C/3.0;
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,4.0*n*n,4.0*n*n*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_Elementwise,false)->RangeMultiplier(4)->Range(64,1024)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Elementwise,true )->RangeMultiplier(4)->Range(64,1024)->UseRealTime();
+//
+//  Band loaded from an expression that can't be fused (bandwidths differ).  The load visits only the
+//  stored band, O(n*k), column by column.
+//
+static void BM_BandLoad(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    SBandMatrix<T> A(n,2,matrix23::random), B(n,4,matrix23::random), S(n,4);
+    for (auto _:state)
+    {
+        S=A+B;
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,9.0*n,2.0*9*n*sizeof(T));
+}
+BENCHMARK(BM_BandLoad)->RangeMultiplier(4)->Range(256,16384)->UseRealTime();
+//
+//  Many threads evaluating small expressions, each result a fresh temporary.  With Arena=true every
+//  thread allocates from its own scoped_arena, released every 64 iterations, instead of malloc.
+//
+template <bool Arena> void BM_SmallExpression(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(n), B=make<FCM>(n);
+    Vector<T> v(n,matrix23::random);
+    auto step=[&]()
+    {
+        FCM C=A+B;
+        FCM D=C*2.0;
+        Vector<T> Dv=D*v;
+        benchmark::DoNotOptimize(Dv);
+    };
+    for (auto _:state)
+    {
+        if constexpr (Arena)
+        {
+            scoped_arena arena(64*4*n*n*sizeof(T));
+            for (int i=0;i<64;i++) step();
+        }
+        else
+            for (int i=0;i<64;i++) step();
+    }
+    set_rates(state,64*(2.0*n*n+2.0*n*n),64*(6.0*n*n)*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_SmallExpression,false)->Arg(8)->Arg(32)->ThreadRange(1,8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SmallExpression,true )->Arg(8)->Arg(32)->ThreadRange(1,8)->UseRealTime();
+
+//
+//  Transpose, Mt is the packing of ~A.
+//
+template <class M, class Mt> void BM_Transpose(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    M A=make<M>(n);
+    for (auto _:state)
+    {
+        Mt C=~A;
+        benchmark::DoNotOptimize(C);
+    }
+    set_rates(state,0,2.0*A.size()*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_Transpose,FCM,FCM)->RangeMultiplier(4)->Range(64,2048);
+BENCHMARK_TEMPLATE(BM_Transpose,FRM,FRM)->RangeMultiplier(4)->Range(64,2048);
+BENCHMARK_TEMPLATE(BM_Transpose,UCM,LCM)->RangeMultiplier(4)->Range(64,2048);
+BENCHMARK_TEMPLATE(BM_Transpose,URM,LRM)->RangeMultiplier(4)->Range(64,2048);
+BENCHMARK_TEMPLATE(BM_Transpose,D  ,D  )->RangeMultiplier(4)->Range(64,1<<16);
+BENCHMARK_TEMPLATE(BM_Transpose,S  ,S  )->RangeMultiplier(4)->Range(64,2048);
+
+//
+//  Construction with fills.  The second argument is the fill_t.
+//
+template <class M> void BM_Fill(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    fill_t f=static_cast<fill_t>(state.range(1));
+    for (auto _:state)
+    {
+        M A=make<M>(n,f);
+        benchmark::DoNotOptimize(A);
+    }
+    set_rates(state,0,make<M>(n,none).size()*sizeof(T));
+}
+#define MATRIX23_FILL(M,n1) BENCHMARK_TEMPLATE(BM_Fill,M)->ArgsProduct({benchmark::CreateRange(64,n1,4),{matrix23::zero,matrix23::random,matrix23::unit}});
+MATRIX23_FILL(FCM,2048)
+MATRIX23_FILL(FRM,2048)
+MATRIX23_FILL(UCM,2048)
+MATRIX23_FILL(URM,2048)
+MATRIX23_FILL(LCM,2048)
+MATRIX23_FILL(D  ,1<<16)
+MATRIX23_FILL(SB ,1<<18)
+MATRIX23_FILL(S  ,2048)
+
+//
+//  blas wrappers.  Destinations are allocated once, outside the timing loop.
+//
+void BM_blas_gemm(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(n), B=make<FCM>(n), C(n,n);
+    for (auto _:state)
+    {
+        gemm(T(1),A,B,T(0),C);
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*n*n*n,3.0*n*n*sizeof(T));
+}
+BENCHMARK(BM_blas_gemm)->RangeMultiplier(2)->Range(64,1024);
+
+void BM_blas_gemm_RM(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FRM A=make<FRM>(n), B=make<FRM>(n), C(n,n);
+    for (auto _:state)
+    {
+        gemm(T(1),A,B,T(0),C);
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*n*n*n,3.0*n*n*sizeof(T));
+}
+BENCHMARK(BM_blas_gemm_RM)->RangeMultiplier(2)->Range(64,1024);
+//
+//  One block step of a blocked algorithm: C11+=A12*B21 on n x n blocks of 2n x 2n matrices.  View=false copies
+//  the blocks out and back, what it took before SubMatrixView.
+//
+template <bool View> void BM_blas_gemm_block(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(2*n), B=make<FCM>(2*n), C=make<FCM>(2*n);
+    iota_view lo(0,n), hi(n,2*n);
+    for (auto _:state)
+    {
+        if constexpr (View)
+            gemm(T(1),A.submatrix(lo,hi),B.submatrix(hi,lo),T(1),C.submatrix(lo,lo));
+        else
+        {
+            FCM A12(n,n), B21(n,n), C11(n,n);
+            for (size_t j=0;j<n;j++)
+                for (size_t i=0;i<n;i++)
+                {
+                    A12(i,j)=A(i,j+n);
+                    B21(i,j)=B(i+n,j);
+                    C11(i,j)=C(i,j);
+                }
+            gemm(T(1),A12,B21,T(1),C11);
+            for (size_t j=0;j<n;j++)
+                for (size_t i=0;i<n;i++) C(i,j)=C11(i,j);
+        }
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*n*n*n,4.0*n*n*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_blas_gemm_block,false)->RangeMultiplier(4)->Range(16,1024);
+BENCHMARK_TEMPLATE(BM_blas_gemm_block,true )->RangeMultiplier(4)->Range(16,1024);
+
+void BM_blas_trmm(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    UFCM A=make<UFCM>(n);
+    FCM B=make<FCM>(n);
+    for (auto _:state)
+    {
+        trmm(T(1),A,B); //B is overwritten, values don't matter for timing.
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,1.0*n*n*n,2.5*n*n*sizeof(T));
+}
+BENCHMARK(BM_blas_trmm)->RangeMultiplier(2)->Range(64,1024);
+
+template <class M> void BM_blas_gemv(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    M A=make<M>(n);
+    Vector<T> x(n,matrix23::random), y(n);
+    for (auto _:state)
+    {
+        gemv(A,x,y);
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2*nonzeros(A),(A.size()+2*n)*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_blas_gemv,FCM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_blas_gemv,FRM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_blas_gemv,SB )->RangeMultiplier(8)->Range(64,1<<18);
+BENCHMARK_TEMPLATE(BM_blas_gemv,S  )->RangeMultiplier(4)->Range(64,4096);
+
+template <class M> void BM_blas_tpmv(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    M A=make<M>(n);
+    Vector<T> x(n,matrix23::random);
+    for (auto _:state)
+    {
+        tpmv(A,x); //x is overwritten in place.
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2*nonzeros(A),(A.size()+2*n)*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_blas_tpmv,UCM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_blas_tpmv,URM)->RangeMultiplier(4)->Range(64,4096);
+BENCHMARK_TEMPLATE(BM_blas_tpmv,LCM)->RangeMultiplier(4)->Range(64,4096);
+
+//
+//  LU with partial pivoting, native getrf against lapack dgetrf when it was found at configure time.
+//  Both factor a fresh copy of A each time, the copy is n^2 against 2/3 n^3 flops.
+//
+#ifdef MATRIX23_LAPACK
+extern "C" void dgetrf_(const int* m, const int* n, double* A, const int* lda, int* ipiv, int* info);
+extern "C" void dpptrf_(const char* uplo, const int* n, double* AP, int* info);
+#endif
+
+template <bool Lapack> void BM_getrf(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    FCM A=make<FCM>(n), F(A);
+    std::vector<size_t> ipiv(n);
+    std::vector<int> ipiv32(n);
+    for (auto _:state)
+    {
+        F=A;
+        auto s=F.strided();
+        if constexpr (Lapack)
+        {
+#ifdef MATRIX23_LAPACK
+            int in=n, ld=s.cs, info;
+            dgetrf_(&in,&in,s.data,&ld,ipiv32.data(),&info);
+#endif
+        }
+        else
+            matrix23::native::getrf(n,n,s.data,s.cs,ipiv.data());
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0/3.0*n*n*n,2.0*n*n*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_getrf,false)->RangeMultiplier(2)->Range(64,2048);
+#ifdef MATRIX23_LAPACK
+BENCHMARK_TEMPLATE(BM_getrf,true )->RangeMultiplier(2)->Range(64,2048);
+#endif
+
+void BM_lu_solve(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    matrix23::LU<T> lu(make<FCM>(n));
+    FCM B=make<FCM>(n), X(B);
+    for (auto _:state)
+    {
+        X=B;
+        lu.solve_in_place(X);
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,2.0*n*n*n,3.0*n*n*sizeof(T));
+}
+BENCHMARK(BM_lu_solve)->RangeMultiplier(4)->Range(64,1024);
+
+//
+//  Cholesky in packed upper storage: native column by column (pptf2, the dpptrf algorithm), native by panels
+//  (pptrf), and lapack dpptrf.  A is n(n+1)/2 values, copied fresh each time.
+//
+enum class pptrf_kind {unblocked, blocked, lapack};
+template <pptrf_kind Kind> void BM_pptrf(benchmark::State& state)
+{
+    size_t n=state.range(0);
+    matrix23::SymmetricMatrixCM<T> A(n,matrix23::random);
+    for (size_t i=0;i<n;i++) A(i,i)+=n;
+    std::vector<T> AP(A.begin(),A.end());
+    for (auto _:state)
+    {
+        std::copy(A.begin(),A.end(),AP.begin());
+        if constexpr (Kind==pptrf_kind::unblocked)
+            matrix23::native::pptf2(n,AP.data());
+        else if constexpr (Kind==pptrf_kind::blocked)
+            matrix23::native::pptrf(n,AP.data());
+        else
+        {
+#ifdef MATRIX23_LAPACK
+            int in=n, info;
+            dpptrf_("U",&in,AP.data(),&info);
+#endif
+        }
+        benchmark::ClobberMemory();
+    }
+    set_rates(state,1.0/3.0*n*n*n,1.0*n*n*sizeof(T));
+}
+BENCHMARK_TEMPLATE(BM_pptrf,pptrf_kind::unblocked)->RangeMultiplier(2)->Range(64,2048);
+BENCHMARK_TEMPLATE(BM_pptrf,pptrf_kind::blocked  )->RangeMultiplier(2)->Range(64,2048);
+#ifdef MATRIX23_LAPACK
+BENCHMARK_TEMPLATE(BM_pptrf,pptrf_kind::lapack   )->RangeMultiplier(2)->Range(64,2048);
+#endif
+
+BENCHMARK_MAIN();
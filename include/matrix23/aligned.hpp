@@ -0,0 +1,49 @@
+// File: aligned.hpp  Cache line aligned storage and padded leading dimensions.
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "matrix23/arena.hpp"
+
+//
+//  std::valarray makes no promise about alignment, so SIMD loads of a column could straddle cache
+//  lines.  aligned_data<T> is a std::vector whose buffer starts on a 64 byte boundary, it can be used
+//  anywhere a Matrix or Vector takes a data type D, and is the default_data_type.
+//  The memory comes from the thread's current resource when the storage is constructed, see arena.hpp.
+//  padded_ld() rounds a leading dimension up to a whole number of cache lines, and steps off
+//  multiples of 4K so that columns of a power of two sized matrix don't map to the same cache set.
+//
+namespace matrix23
+{
+
+inline constexpr size_t cache_line=64;
+
+template <class T, size_t Align=cache_line> struct aligned_allocator
+{
+    typedef T value_type;
+    template <class U> struct rebind {typedef aligned_allocator<U,Align> other;};
+    aligned_allocator() : resource(current_resource()) {}
+    explicit aligned_allocator(std::pmr::memory_resource* r) : resource(r) {}
+    template <class U> aligned_allocator(const aligned_allocator<U,Align>& a) : resource(a.resource) {}
+
+    T* allocate(size_t n) {return static_cast<T*>(resource->allocate(n*sizeof(T),Align));}
+    void deallocate(T* p, size_t n) {resource->deallocate(p,n*sizeof(T),Align);}
+    // Copies don't inherit an arena, they use whatever is current where the copy is made.
+    aligned_allocator select_on_container_copy_construction() const {return aligned_allocator();}
+    template <class U> bool operator==(const aligned_allocator<U,Align>& a) const {return resource==a.resource;}
+
+    std::pmr::memory_resource* resource;
+};
+
+template <class T> using aligned_data=std::vector<T,aligned_allocator<T>>;
+
+// Leading dimension >= n for column major data (or row major with n columns).
+template <class T> size_t padded_ld(size_t n)
+{
+    constexpr size_t per_line= sizeof(T)<cache_line ? cache_line/sizeof(T) : 1;
+    size_t ld=(n+per_line-1)/per_line*per_line;
+    if (ld>0 && ld*sizeof(T)%4096==0) ld+=per_line; //Critical stride.
+    return ld;
+}
+
+} //namespace matrix23
@@ -0,0 +1,53 @@
+// File: arena.hpp  Per thread memory resource, and scoped arenas for expression temporaries.
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+//
+//  All matrix and vector storage (see aligned_allocator in aligned.hpp) is allocated from the calling
+//  thread's current memory resource, normally new/delete.  A scoped_arena switches it to a monotonic
+//  buffer for its lifetime, so the temporaries of a whole computation step come from one block and are
+//  released together when the arena goes out of scope, with no malloc calls or contention in between:
+//      {
+//          scoped_arena arena;
+//          for (...) C+=A*B+D*E;   //Temporaries come from the arena.
+//      }                           //All released here.
+//  Storage remembers the resource it came from, so only objects constructed inside the scope live in
+//  the arena and they must not outlive it.  Copies made outside the scope go back to the heap.
+//
+namespace matrix23
+{
+
+// The calling thread's resource.  Worker threads keep their own, normally new/delete.
+inline std::pmr::memory_resource*& resource_slot()
+{
+    thread_local std::pmr::memory_resource* r=std::pmr::new_delete_resource();
+    return r;
+}
+inline std::pmr::memory_resource* current_resource() {return resource_slot();}
+// Returns the previous resource.
+inline std::pmr::memory_resource* set_current_resource(std::pmr::memory_resource* r)
+{
+    std::pmr::memory_resource* previous=resource_slot();
+    resource_slot()=r;
+    return previous;
+}
+
+class scoped_arena
+{
+public:
+    // Blocks start at initial_bytes and grow geometrically, taken from the enclosing resource.
+    explicit scoped_arena(size_t initial_bytes=size_t(1)<<20)
+    : arena(initial_bytes,current_resource()), previous(set_current_resource(&arena)) {}
+    ~scoped_arena() {set_current_resource(previous);} //arena frees its blocks.
+    scoped_arena(const scoped_arena&) = delete;
+    scoped_arena& operator=(const scoped_arena&) = delete;
+
+    std::pmr::memory_resource* resource() {return &arena;}
+private:
+    std::pmr::monotonic_buffer_resource arena;
+    std::pmr::memory_resource* previous;
+};
+
+} //namespace matrix23
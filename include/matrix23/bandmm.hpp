@@ -0,0 +1,135 @@
+// File: bandmm.hpp  Native kernels for products with square banded (SBandPacker) matrices.
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+#include "matrix23/threads.hpp"
+
+//
+//  A band matrix with bandwidth k is stored column by column, 2k+1 slots per column, see SBandPacker:
+//      element (i,l) is at A[l*(2k+1)+k+i-l]
+//  so the non-zero part of each column is contiguous.  The kernels below walk the band diagonals
+//  column by column and only ever touch elements inside the bands.  Band*band costs
+//  n*(2ka+1)*(2kb+1) multiply-adds instead of the n^2 intersections of the generic product view.
+//  Full operands and results are passed as (pointer, row stride, column stride) like native::gemm.
+//  Columns (or rows) of C are independent, so they are cut into blocks for the thread pool.
+//
+namespace matrix23::native
+{
+
+// Tasks for nouter independent columns/rows of C costing about work multiply-adds in total.
+inline size_t band_tasks(size_t nouter, size_t work)
+{
+    return work<size_t(1)<<16 ? 1 : std::min(nouter,4*num_threads());
+}
+// Run f(o) for o in [0,nouter), in blocks, on the thread pool.
+template <class F> void band_parallel(size_t nouter, size_t work, F&& f)
+{
+    size_t ntask=band_tasks(nouter,work);
+    size_t nb=(nouter+ntask-1)/ntask;
+    parallel_for(ntask,[&](size_t t)
+    {
+        for (size_t o=t*nb;o<std::min(nouter,(t+1)*nb);o++) f(o);
+    });
+}
+// Rows [i0,i1] stored in band column l, clipped to [0,n).
+inline size_t band_first(size_t l, size_t k) {return l<k ? 0 : l-k;}
+inline size_t band_last (size_t l, size_t k, size_t n) {return std::min(l+k,n-1);}
+
+//
+//  C=A*B for n x n band matrices.  kc>=ka+kb, the slots of C outside the ka+kb band are zeroed.
+//
+template <class T> void sband_sband(size_t n, const T* A, size_t ka, const T* B, size_t kb, T* C, size_t kc)
+{
+    assert(kc>=ka+kb);
+    if (n==0) return;
+    size_t lda=2*ka+1, ldb=2*kb+1, ldc=2*kc+1;
+    band_parallel(n,n*lda*ldb,[=](size_t j)
+    {
+        T* cj=C+j*ldc+kc-j; //cj[i] is C(i,j), only valid inside the band.
+        std::fill(C+j*ldc,C+(j+1)*ldc,T(0));
+        for (size_t l=band_first(j,kb);l<=band_last(j,kb,n);l++)
+        {
+            T b=B[j*ldb+kb+l-j];
+            const T* al=A+l*lda+ka-l; //al[i] is A(i,l)
+            for (size_t i=band_first(l,ka);i<=band_last(l,ka,n);i++)
+                cj[i]+=al[i]*b;
+        }
+    });
+}
+
+//
+//  C=A*B, A is an n x n band matrix, B and C are full n x m.
+//
+template <class T> void sband_full(size_t n, size_t m, const T* A, size_t ka,
+    const T* B, size_t rsb, size_t csb, T* C, size_t rsc, size_t csc)
+{
+    if (n==0 || m==0) return;
+    size_t lda=2*ka+1;
+    if (rsc==1) // C(:,j)= sum_l A(:,l)*B(l,j)
+        band_parallel(m,m*n*lda,[=](size_t j)
+        {
+            T* cj=C+j*csc;
+            const T* bj=B+j*csb;
+            for (size_t i=0;i<n;i++) cj[i]=T(0);
+            for (size_t l=0;l<n;l++)
+            {
+                T b=bj[l*rsb];
+                const T* al=A+l*lda+ka-l;
+                for (size_t i=band_first(l,ka);i<=band_last(l,ka,n);i++)
+                    cj[i]+=al[i]*b;
+            }
+        });
+    else // C(i,:)= sum_l A(i,l)*B(l,:)
+        band_parallel(n,m*n*lda,[=](size_t i)
+        {
+            T* ci=C+i*rsc;
+            for (size_t j=0;j<m;j++) ci[j*csc]=T(0);
+            for (size_t l=band_first(i,ka);l<=band_last(i,ka,n);l++)
+            {
+                T a=A[l*lda+ka+i-l];
+                const T* bl=B+l*rsb;
+                for (size_t j=0;j<m;j++)
+                    ci[j*csc]+=a*bl[j*csb];
+            }
+        });
+}
+
+//
+//  C=A*B, A and C are full m x n, B is an n x n band matrix.
+//
+template <class T> void full_sband(size_t m, size_t n, const T* A, size_t rsa, size_t csa,
+    const T* B, size_t kb, T* C, size_t rsc, size_t csc)
+{
+    if (n==0 || m==0) return;
+    size_t ldb=2*kb+1;
+    if (rsc==1) // C(:,j)= sum_l A(:,l)*B(l,j)
+        band_parallel(n,m*n*ldb,[=](size_t j)
+        {
+            T* cj=C+j*csc;
+            for (size_t i=0;i<m;i++) cj[i]=T(0);
+            for (size_t l=band_first(j,kb);l<=band_last(j,kb,n);l++)
+            {
+                T b=B[j*ldb+kb+l-j];
+                const T* al=A+l*csa;
+                for (size_t i=0;i<m;i++)
+                    cj[i]+=al[i*rsa]*b;
+            }
+        });
+    else // C(i,:)= sum_l A(i,l)*B(l,:)
+        band_parallel(m,m*n*ldb,[=](size_t i)
+        {
+            T* ci=C+i*rsc;
+            const T* ai=A+i*rsa;
+            for (size_t j=0;j<n;j++) ci[j*csc]=T(0);
+            for (size_t l=0;l<n;l++)
+            {
+                T a=ai[l*csa];
+                for (size_t j=band_first(l,kb);j<=band_last(l,kb,n);j++)
+                    ci[j*csc]+=a*B[j*ldb+kb+l-j];
+            }
+        });
+}
+
+} //namespace matrix23::native
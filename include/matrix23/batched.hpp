@@ -0,0 +1,133 @@
+// File: batched.hpp  Batched gemm/gemv over many small same shaped matrices.
+#pragma once
+
+#include "matrix23/matrix.hpp"
+#include "matrix23/batchmm.hpp"
+#include <ranges>
+
+//
+//  Two ways to hand over a batch:
+//  1) Ranges of existing matrices and vectors (the pointer array form):
+//         std::vector<FullMatrixCM<double>> A,B,C;  ...
+//         gemm_batched(1.0,A,B,0.0,C);    //C[b]=A[b]*B[b]
+//  2) A MatrixBatch, which stores the whole batch interleaved so that each multiply-add runs across
+//     a cache line of matrices (8 doubles).  Best when the batch lives its whole life in this form.
+//         MatrixBatch<double> A(8,8,100000),B(8,8,100000),C(8,8,100000);
+//         gemm(1.0,A,B,0.0,C);
+//  All of them run on the thread pool when the batch is big enough.
+//
+namespace matrix23
+{
+
+template <class T> class MatrixBatch
+{
+public:
+    typedef T value_type;
+    static constexpr size_t lanes= sizeof(T)<cache_line ? cache_line/sizeof(T) : 1; //Matrices per group.
+
+    MatrixBatch(size_t nr, size_t nc, size_t count) : nrows(nr), ncols(nc), nmat(count), data(groups()*nr*nc*lanes) {}
+    MatrixBatch(size_t nr, size_t nc, size_t count, fill_t f) : MatrixBatch(nr,nc,count)
+    {
+        for (size_t b=0;b<count;b++) set(b,FullMatrixCM<T>(nr,nc,f));
+    }
+    // From a range of same shaped matrices.
+    template <std::ranges::sized_range R> explicit MatrixBatch(const R& ms)
+    : MatrixBatch(std::ranges::empty(ms) ? 0 : std::ranges::begin(ms)->nr(), std::ranges::empty(ms) ? 0 : std::ranges::begin(ms)->nc(), std::ranges::size(ms))
+    {
+        size_t b=0;
+        for (const auto& m:ms) set(b++,m);
+    }
+
+    size_t nr    () const {return nrows;}
+    size_t nc    () const {return ncols;}
+    size_t size  () const {return nmat;} //# of matrices.
+    size_t groups() const {return (nmat+lanes-1)/lanes;}
+
+    T  operator()(size_t b, size_t i, size_t j) const {return data[offset(b,i,j)];}
+    T& operator()(size_t b, size_t i, size_t j)       {return data[offset(b,i,j)];}
+    void set(size_t b, const isMatrix auto& m)
+    {
+        assert(m.nr()==nr() && m.nc()==nc());
+        for (size_t j=0;j<nc();j++)
+            for (size_t i=0;i<nr();i++)
+                (*this)(b,i,j)=m(i,j);
+    }
+    FullMatrixCM<T> get(size_t b) const
+    {
+        FullMatrixCM<T> m(nr(),nc());
+        for (size_t j=0;j<nc();j++)
+            for (size_t i=0;i<nr();i++)
+                m(i,j)=(*this)(b,i,j);
+        return m;
+    }
+    const T* raw() const {return data.data();}
+          T* raw()       {return data.data();}
+private:
+    size_t offset(size_t b, size_t i, size_t j) const
+    {
+        assert(b<nmat && i<nrows && j<ncols);
+        return (b/lanes)*nrows*ncols*lanes + (i+j*nrows)*lanes + b%lanes;
+    }
+    size_t nrows,ncols,nmat;
+    aligned_data<T> data; //The unused lanes of the last group are just padding.
+};
+
+// C[b]=alpha*A[b]*B[b]+beta*C[b]
+template <class T> void gemm(T alpha, const MatrixBatch<T>& A, const MatrixBatch<T>& B, T beta, MatrixBatch<T>& C)
+{
+    assert(A.size()==B.size() && A.size()==C.size());
+    assert(A.nc()==B.nr() && A.nr()==C.nr() && B.nc()==C.nc());
+    native::gemm_compact<MatrixBatch<T>::lanes>(C.nr(),C.nc(),A.nc(),alpha,A.raw(),B.raw(),beta,C.raw(),C.groups());
+}
+// y[b]=alpha*A[b]*x[b]+beta*y[b], x and y are batches of single columns.
+template <class T> void gemv(T alpha, const MatrixBatch<T>& A, const MatrixBatch<T>& x, T beta, MatrixBatch<T>& y)
+{
+    assert(x.nc()==1 && y.nc()==1);
+    gemm(alpha,A,x,beta,y);
+}
+
+// C[b]=alpha*A[b]*B[b]+beta*C[b] for random access ranges of full CM or RM matrices.
+template <class T, std::ranges::random_access_range RA, std::ranges::random_access_range RB, std::ranges::random_access_range RC>
+void gemm_batched(T alpha, const RA& A, const RB& B, T beta, RC& C)
+{
+    size_t count=std::ranges::size(C);
+    assert(std::ranges::size(A)==count && std::ranges::size(B)==count);
+    if (count==0) return;
+    size_t m=C[0].nr(), n=C[0].nc(), k=A[0].nc();
+    native::batch_parallel(count,m*n*k,[&](size_t b)
+    {
+        const auto& a=A[b];
+        const auto& bb=B[b];
+        auto& c=C[b];
+        assert(a.nr()==m && a.nc()==k && bb.nr()==k && bb.nc()==n && c.nr()==m && c.nc()==n);
+        if (c.size()==0) return;
+        auto pa=a.packer();
+        auto pb=bb.packer();
+        auto pc=c.packer();
+        native::gemm_small(m,n,k,alpha,k==0 ? nullptr : &*a.begin(),pa.row_stride(),pa.col_stride(),
+                                      k==0 ? nullptr : &*bb.begin(),pb.row_stride(),pb.col_stride(),
+                                 beta,&*c.begin(),pc.row_stride(),pc.col_stride());
+    });
+}
+// y[b]=alpha*A[b]*x[b]+beta*y[b] for random access ranges of full matrices and Vectors.
+template <class T, std::ranges::random_access_range RA, std::ranges::random_access_range RX, std::ranges::random_access_range RY>
+void gemv_batched(T alpha, const RA& A, const RX& x, T beta, RY& y)
+{
+    size_t count=std::ranges::size(y);
+    assert(std::ranges::size(A)==count && std::ranges::size(x)==count);
+    if (count==0) return;
+    size_t m=A[0].nr(), n=A[0].nc();
+    native::batch_parallel(count,m*n,[&](size_t b)
+    {
+        const auto& a=A[b];
+        assert(a.nr()==m && a.nc()==n && x[b].size()==n && y[b].size()==m);
+        if (m==0) return;
+        auto pa=a.packer();
+        // x and y are n x 1 and m x 1 column major matrices.
+        native::gemm_small(m,size_t(1),n,alpha,n==0 ? nullptr : &*a.begin(),pa.row_stride(),pa.col_stride(),
+                                              n==0 ? nullptr : &*x[b].begin(),size_t(1),n,
+                                         beta,&*y[b].begin(),size_t(1),m);
+    });
+}
+
+} //namespace matrix23
@@ -0,0 +1,114 @@
+// File: batchmm.hpp  Native kernels for batches of small independent matrix products.
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include "matrix23/threads.hpp"
+
+//
+//  For 8x8 ... 64x64 products the packing and blocking of native::gemm costs more than the
+//  arithmetic.  These kernels skip all of that:
+//      gemm_small            one product straight from the operands, (pointer, row stride, col stride).
+//      gemm_strided_batched  count products, operand b at A+b*sa, B+b*sb, C+b*sc.
+//      gemm_batched          count products from arrays of pointers.
+//      gemm_compact          groups of L products stored interleaved element by element, so each
+//                            multiply-add runs across L matrices at once, one cache line per element.
+//  Batches are cut into blocks for the thread pool.
+//
+namespace matrix23::native
+{
+
+// Run f(b) for b in [0,count) in blocks on the thread pool.  work is multiply-adds per item.
+template <class F> void batch_parallel(size_t count, size_t work, F&& f)
+{
+    size_t ntask= count*work<(size_t(1)<<18) ? 1 : std::min(count,4*num_threads());
+    size_t nb=(count+ntask-1)/ntask;
+    parallel_for(ntask,[&](size_t t)
+    {
+        for (size_t b=t*nb;b<std::min(count,(t+1)*nb);b++) f(b);
+    });
+}
+
+//
+//  C=alpha*A*B+beta*C, no packing.  Column j of C is accumulated as axpys down the columns of A,
+//  which vectorize when A and C are column major.
+//
+template <class T> void gemm_small(size_t m, size_t n, size_t k,
+    T alpha, const T* A, size_t rsa, size_t csa,
+             const T* B, size_t rsb, size_t csb,
+    T beta ,       T* C, size_t rsc, size_t csc)
+{
+    for (size_t j=0;j<n;j++)
+    {
+        T* cj=C+j*csc;
+        if (beta==T(0))
+            for (size_t i=0;i<m;i++) cj[i*rsc]=T(0);
+        else if (beta!=T(1))
+            for (size_t i=0;i<m;i++) cj[i*rsc]*=beta;
+        for (size_t l=0;l<k;l++)
+        {
+            const T* al=A+l*csa;
+            T blj=alpha*B[l*rsb+j*csb];
+            if (rsa==1 && rsc==1)
+                for (size_t i=0;i<m;i++) cj[i]+=al[i]*blj;
+            else
+                for (size_t i=0;i<m;i++) cj[i*rsc]+=al[i*rsa]*blj;
+        }
+    }
+}
+
+template <class T> void gemm_strided_batched(size_t m, size_t n, size_t k,
+    T alpha, const T* A, size_t rsa, size_t csa, size_t sa,
+             const T* B, size_t rsb, size_t csb, size_t sb,
+    T beta ,       T* C, size_t rsc, size_t csc, size_t sc, size_t count)
+{
+    batch_parallel(count,m*n*k,[=](size_t b)
+    {
+        gemm_small(m,n,k,alpha,A+b*sa,rsa,csa,B+b*sb,rsb,csb,beta,C+b*sc,rsc,csc);
+    });
+}
+
+template <class T> void gemm_batched(size_t m, size_t n, size_t k,
+    T alpha, const T* const* A, size_t rsa, size_t csa,
+             const T* const* B, size_t rsb, size_t csb,
+    T beta ,       T* const* C, size_t rsc, size_t csc, size_t count)
+{
+    batch_parallel(count,m*n*k,[=](size_t b)
+    {
+        gemm_small(m,n,k,alpha,A[b],rsa,csa,B[b],rsb,csb,beta,C[b],rsc,csc);
+    });
+}
+
+//
+//  Compact layout: a group holds L column major m x n matrices, element (i,j) of matrix l is at
+//  group[(i+j*m)*L+l].  Groups follow each other.  The lane loops have a constant trip count and
+//  no dependencies between lanes, so they compile to plain vector multiply-adds.
+//
+template <size_t L, class T> void gemm_compact(size_t m, size_t n, size_t k,
+    T alpha, const T* A, const T* B, T beta, T* C, size_t ngroups)
+{
+    batch_parallel(ngroups,L*m*n*k,[=](size_t g)
+    {
+        const T* a=A+g*m*k*L;
+        const T* b=B+g*k*n*L;
+              T* c=C+g*m*n*L;
+        for (size_t j=0;j<n;j++)
+            for (size_t i=0;i<m;i++)
+            {
+                T acc[L]={};
+                for (size_t l=0;l<k;l++)
+                {
+                    const T* ail=a+(i+l*m)*L;
+                    const T* blj=b+(l+j*k)*L;
+                    for (size_t v=0;v<L;v++) acc[v]+=ail[v]*blj[v];
+                }
+                T* cij=c+(i+j*m)*L;
+                if (beta==T(0))
+                    for (size_t v=0;v<L;v++) cij[v]=alpha*acc[v];
+                else
+                    for (size_t v=0;v<L;v++) cij[v]=alpha*acc[v]+beta*cij[v];
+            }
+    });
+}
+
+} //namespace matrix23::native
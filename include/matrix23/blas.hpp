@@ -4,6 +4,8 @@
 #include "matrix23/matrix.hpp"
 namespace matrix23 {
 
+// All routines are compiled in src/blas.cpp for T = float, double, std::complex<float> and std::complex<double>.
+//
 // https://www.netlib.org/lapack/explore-html/d7/dda/group__gemv_ga4ac1b675072d18f902db8a310784d802.html#ga4ac1b675072d18f902db8a310784d802
 // DGEMV  performs one of the matrix-vector operations
 //
@@ -26,20 +28,66 @@ template <class T> void tpmv(const LowerTriangularMatrixRM<T>& A, Vector<T>& x);
 
 
 
+//
+//  Opt in: from now on FullMatrixCM<T> products assigned to a full matrix (C=A*B) call s/d/c/zgemm
+//  straight into C's storage once m*n*k >= n^3.  Smaller products stay on the native engine.
+//  n=0 turns the offload off again.
+//
+void set_blas_offload(size_t n=64);
+
+// C := alpha*A*B + beta*C for any mix of row and column major A, B and C.  No data is copied.
 template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixCM<T>& C);
-// template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixRM<T>& C);
+template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixCM<T>& C);
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixCM<T>& C);
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixCM<T>& C);
+template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixRM<T>& C);
+template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixRM<T>& C);
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixRM<T>& C);
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixRM<T>& C);
+//
+//  The same on raw full storage, (pointer, row stride, col stride) with one stride 1.  Anything with strided(),
+//  i.e. full matrices and SubMatrixView blocks of them, goes in without copying, ld is the parent's.
+//
+template <class T> void gemm(size_t m, size_t n, size_t k, T alpha, strided_data<const T> A, strided_data<const T> B, T beta, strided_data<T> C);
+template <class T> void gemv(size_t m, size_t n, T alpha, strided_data<const T> A, const T* x, T beta, T* y); //A is m x n.
+template <class T, class Ma, class Mb, class Mc> requires hasStrided<Ma,T> && hasStrided<Mb,T> && requires (Mc& c) {{c.strided()} -> std::same_as<strided_data<T>>;}
+void gemm(T alpha, const Ma& A, const Mb& B, T beta, Mc&& C)
+{
+    assert(A.nc()==B.nr());
+    assert(A.nr()==C.nr());
+    assert(B.nc()==C.nc());
+    gemm(C.nr(),C.nc(),A.nc(),alpha,strided_data<const T>(A.strided()),strided_data<const T>(B.strided()),beta,C.strided());
+}
+template <class T, class Ma> requires hasStrided<Ma,T> void gemv(T alpha, const Ma& A, const Vector<T>& x, T beta, Vector<T>& y)
+{
+    assert(A.nc()==x.size());
+    assert(A.nr()==y.size());
+    if (A.nr()>0) gemv(A.nr(),A.nc(),alpha,strided_data<const T>(A.strided()),A.nc()==0 ? nullptr : &*x.begin(),beta,&*y.begin());
+}
 //                                                                       A has to square
 template <class T> void trmm(T alpha, const UpperTriangularMatrixFCM<T>& A, FullMatrixCM<T>& B);
 template <class T> void trmm(T alpha, const LowerTriangularMatrixFCM<T>& A, FullMatrixCM<T>& B);
 template <class T> void trmm(T alpha, FullMatrixCM<T>& B, const UpperTriangularMatrixFCM<T>& A);
 template <class T> void trmm(T alpha, FullMatrixCM<T>& B, const LowerTriangularMatrixFCM<T>& A);
 //
+//  Symmetric A.  spmv works on the packed upper triangle of SymmetricMatrixCM, symv, symm and syrk on full storage
+//  where only the upper triangle is read.  syrk fills both triangles of C.  spmv and symv are float/double only,
+//  for complex types blas only has the hermitian versions.
+//
+template <class T> void spmv(T alpha, const SymmetricMatrixCM<T>& A, const Vector<T>& x, T beta, Vector<T>& y );
+template <class T> void symv(T alpha, const SymmetricMatrixFCM<T>& A, const Vector<T>& x, T beta, Vector<T>& y );
+template <class T> void symm(T alpha, const SymmetricMatrixFCM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixCM<T>& C); //C=A*B
+template <class T> void symm(T alpha, const FullMatrixCM<T>& B, const SymmetricMatrixFCM<T>& A, T beta, FullMatrixCM<T>& C); //C=B*A
+template <class T> void syrk(T alpha, const FullMatrixCM<T>& A, T beta, SymmetricMatrixFCM<T>& C); //C=A*A^T
+//
 //  Convenience helper functions so users don't need to worry about alpha.beta and constructing the return container.
 //
 template <class T, isMatrix Mat> void gemv(const Mat& A, const Vector<T>& x,  Vector<T>& y) {gemv(T(1),A,x,T(0),y);}
 template <class T, isMatrix Mat> void gevm(const Mat& A, const Vector<T>& x,  Vector<T>& y) {gevm(T(1),A,x,T(0),y);}
 template <class T> void gemv(const SBandMatrix<T>& A, const Vector<T>& x,  Vector<T>& y) {gbmv(T(1),A,x,T(0),y);}
 template <class T> void gevm(const SBandMatrix<T>& A, const Vector<T>& x,  Vector<T>& y) {gbvm(T(1),A,x,T(0),y);}
+template <class T> void gemv(const SymmetricMatrixCM<T>& A, const Vector<T>& x,  Vector<T>& y) {spmv(T(1),A,x,T(0),y);}
+template <class T> void gemv(const SymmetricMatrixFCM<T>& A, const Vector<T>& x,  Vector<T>& y) {symv(T(1),A,x,T(0),y);}
 
 template <class T, isMatrix Mat> Vector<T> blasmv(const Mat& M, const Vector<T>& v)
 {
@@ -62,16 +110,31 @@ template <class T> FullMatrixCM<T> blasmm(const FullMatrixCM<T>& A, const FullMa
 {
     assert(A.nc()==B.nr());
     FullMatrixCM<T> C(A.nr(),B.nc());
-    gemm(1.0,A,B,0.0,C);
+    gemm(T(1),A,B,T(0),C);
+    return C;
+}
+template <class T> FullMatrixRM<T> blasmm(const FullMatrixRM<T>& A, const FullMatrixRM<T>& B)
+{
+    assert(A.nc()==B.nr());
+    FullMatrixRM<T> C(A.nr(),B.nc());
+    gemm(T(1),A,B,T(0),C);
+    return C;
+}
+// Mixed layouts come back column major, same as blas.
+template <class T> FullMatrixCM<T> blasmm(const FullMatrixCM<T>& A, const FullMatrixRM<T>& B)
+{
+    assert(A.nc()==B.nr());
+    FullMatrixCM<T> C(A.nr(),B.nc());
+    gemm(T(1),A,B,T(0),C);
+    return C;
+}
+template <class T> FullMatrixCM<T> blasmm(const FullMatrixRM<T>& A, const FullMatrixCM<T>& B)
+{
+    assert(A.nc()==B.nr());
+    FullMatrixCM<T> C(A.nr(),B.nc());
+    gemm(T(1),A,B,T(0),C);
     return C;
 }
-// template <class T> FullMatrixRM<T> blasmm(const FullMatrixRM<T>& A, const FullMatrixRM<T>& B)
-// {
-//     assert(A.nc()==B.nr());
-//     FullMatrixRM<T> C(A.nr(),B.nc());
-//     gemm(1.0,A,B,0.0,C);
-//     return C;
-// }
 
 
 } //namespace matrix23
\ No newline at end of file
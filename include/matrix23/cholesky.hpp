@@ -0,0 +1,70 @@
+// File: cholesky.hpp  Cholesky factorization and solves in packed symmetric storage.
+#pragma once
+
+#include "matrix23/matrix.hpp"
+#include "matrix23/pptrf.hpp"
+#include <algorithm>
+
+//
+//  SymmetricMatrixCM stores its upper triangle packed like lapack 'U', which is also how UpperTriangularMatrixCM
+//  is stored.  So A=U^T*U is computed straight in that storage with native::pptrf, no full n x n copy:
+//      Cholesky<double> ch(A);               //A is SymmetricMatrixCM, its n(n+1)/2 values are copied once
+//      Vector<double> x=ch.solve(b);
+//      const UpperTriangularMatrixCM<double>& U=ch.factor();
+//  or in place, when the upper triangle of A is already held in an UpperTriangularMatrixCM:
+//      size_t info=cholesky_in_place(U);      //U is overwritten with the factor, like dpptrf
+//  A that is not positive definite is not an error when factoring, positive_definite() says so and solve
+//  asserts on it.
+//
+namespace matrix23
+{
+
+// The upper triangle of A in, U with A=U^T*U out.  Returns 0, or 1+ the first column that is not positive definite.
+template <class T> size_t cholesky_in_place(UpperTriangularMatrixCM<T>& U)
+{
+    assert(U.nr()==U.nc());
+    return U.nr()==0 ? 0 : native::pptrf(U.nr(),&*U.begin());
+}
+
+template <class T> class Cholesky
+{
+public:
+    explicit Cholesky(const SymmetricMatrixCM<T>& A) : U(A.nr(),A.nc())
+    {
+        std::copy(A.begin(),A.end(),U.begin()); //Same packing.
+        status=cholesky_in_place(U);
+    }
+    explicit Cholesky(UpperTriangularMatrixCM<T> A) : U(std::move(A)), status(cholesky_in_place(U)) {}
+
+    const UpperTriangularMatrixCM<T>& factor() const {return U;}
+    // 0, or 1+ the first column that is not positive definite.  The factor is only partial then.
+    size_t info() const {return status;}
+    bool positive_definite() const {return status==0;}
+
+    void solve_in_place(FullMatrixCM<T>& B) const
+    {
+        assert(B.nr()==U.nr());
+        auto s=B.strided();
+        solve_in_place(B.nc(),s.data,s.cs);
+    }
+    void solve_in_place(Vector<T>& b) const
+    {
+        assert(b.size()==U.nr());
+        if (b.size()>0) solve_in_place(1,&*b.begin(),b.size());
+    }
+    FullMatrixCM<T> solve(FullMatrixCM<T> B) const {solve_in_place(B);return B;}
+    Vector<T>       solve(Vector<T>       b) const {solve_in_place(b);return b;}
+private:
+    void solve_in_place(size_t n, T* B, size_t ldb) const
+    {
+        assert(positive_definite());
+        if (U.nr()>0) native::pptrs(U.nr(),n,&*U.begin(),B,ldb);
+    }
+    UpperTriangularMatrixCM<T> U;
+    size_t status;
+};
+
+template <class T> Vector<T>       solve(const SymmetricMatrixCM<T>& A, Vector<T>       b) {return Cholesky<T>(A).solve(std::move(b));}
+template <class T> FullMatrixCM<T> solve(const SymmetricMatrixCM<T>& A, FullMatrixCM<T> B) {return Cholesky<T>(A).solve(std::move(B));}
+
+} //namespace matrix23
@@ -0,0 +1,43 @@
+// File: fixedmm.hpp  Unrolled native kernels for products of compile time sized matrices.
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+//
+//  All operands are column major with no padding, A is M x K, B is K x N.  Every loop is expanded
+//  with index_sequence folds so a 4x4 product is 64 multiply-adds with constant offsets, no loops,
+//  no branches.  Only meant for small sizes, code size grows like M*N*K.
+//
+namespace matrix23::native
+{
+
+// sum_l a[l*sa]*b[l*sb], l<K.
+template <size_t K, size_t sa, size_t sb, class T> constexpr T fixed_dot(const T* a, const T* b)
+{
+    return [&]<size_t... L>(std::index_sequence<L...>) {return (T(0) + ... + (a[L*sa]*b[L*sb]));}
+        (std::make_index_sequence<K>());
+}
+
+// C=A*B
+template <size_t M, size_t K, size_t N, class T> constexpr void fixed_gemm(const T* A, const T* B, T* C)
+{
+    [&]<size_t... IJ>(std::index_sequence<IJ...>) {((C[IJ]=fixed_dot<K,M,1>(A+IJ%M,B+IJ/M*K)),...);}
+        (std::make_index_sequence<M*N>());
+}
+
+// y=A*x
+template <size_t M, size_t N, class T> constexpr void fixed_gemv(const T* A, const T* x, T* y)
+{
+    [&]<size_t... I>(std::index_sequence<I...>) {((y[I]=fixed_dot<N,M,1>(A+I,x)),...);}
+        (std::make_index_sequence<M>());
+}
+
+// y=x*A
+template <size_t M, size_t N, class T> constexpr void fixed_gevm(const T* A, const T* x, T* y)
+{
+    [&]<size_t... J>(std::index_sequence<J...>) {((y[J]=fixed_dot<M,1,1>(A+J*M,x)),...);}
+        (std::make_index_sequence<N>());
+}
+
+} //namespace matrix23::native
@@ -0,0 +1,286 @@
+// File: gemm.hpp  Native cache blocked matrix-matrix multiplication engine.
+#pragma once
+
+#include <cstddef>
+#include <complex>
+#include <algorithm>
+#include "matrix23/threads.hpp"
+#include "matrix23/aligned.hpp"
+#include "matrix23/simd.hpp"
+
+//
+//  This is a GotoBLAS/BLIS style engine for C = alpha*A*B + beta*C.  The layers are:
+//      1) Loop over NC wide column panels of B and C.
+//      2) Loop over KC deep slices of the k dimension.  Pack B(kc,nc) into NR wide slivers.
+//      3) Loop over MC tall row panels of A.  Pack A(mc,kc) into MR tall slivers.
+//      4) Macro kernel: loop over the MR x NR tiles of C and call the micro kernel.
+//  The packed B panel is sized to stay in L3 (L2 on some CPUs), the packed A panel in L2 and
+//  one B sliver in L1.  The micro kernel keeps an MR x NR block of C in registers and
+//  streams through the packed slivers with unit stride, which is what the compiler needs
+//  in order to vectorize it.
+//
+//  All matrices are passed as (pointer, row stride, column stride) in the BLIS style, so
+//  row major, column major and transposed operands all go through the same code:
+//      element (i,j) of A is at A[i*rsa+j*csa]
+//  For a column major matrix rs=1,cs=nr.  For a row major matrix rs=nc,cs=1.
+//
+//  See: https://github.com/flame/how-to-optimize-gemm/wiki#the-gotoblasblis-approach-to-optimizing-matrix-matrix-multiplication---step-by-step
+//
+namespace matrix23::native
+{
+
+//
+//  Blocking parameters.  MR x NR is the register block, it needs MR*NR/simd_width accumulators
+//  plus a few registers for the A and B slivers.  KC*NR*sizeof(T) should fit in L1 and
+//  MC*KC*sizeof(T) in L2.
+//
+template <class T> struct gemm_blocking
+{
+    static constexpr size_t MR=4, NR=4, KC=256, MC=64, NC=2048;
+};
+template <> struct gemm_blocking<double>
+{
+#if defined(__AVX512F__)
+    static constexpr size_t MR=32, NR=6, KC=256, MC=128, NC=4096;
+#elif defined(__AVX2__)
+    static constexpr size_t MR=8, NR=6, KC=256, MC=96, NC=4096;
+#else
+    static constexpr size_t MR=8, NR=4, KC=256, MC=96, NC=4096;
+#endif
+};
+template <> struct gemm_blocking<float>
+{
+#if defined(__AVX512F__)
+    static constexpr size_t MR=64, NR=6, KC=256, MC=128, NC=4096;
+#elif defined(__AVX2__)
+    static constexpr size_t MR=16, NR=6, KC=256, MC=96, NC=4096;
+#else
+    static constexpr size_t MR=16, NR=4, KC=256, MC=96, NC=4096;
+#endif
+};
+
+//
+//  Pack an mc x kc block of A into MR tall slivers.  Within a sliver the data is
+//  laid out column by column, so the micro kernel reads MR contiguous values per k step.
+//  Rows beyond mc in the last sliver are zero padded.
+//
+template <class T, size_t MR> void pack_A(size_t mc, size_t kc, const T* A, size_t rsa, size_t csa, T* Ap)
+{
+    for (size_t i0=0;i0<mc;i0+=MR)
+    {
+        size_t mr=std::min(MR,mc-i0);
+        const T* a=A+i0*rsa;
+        for (size_t p=0;p<kc;p++,Ap+=MR)
+        {
+            const T* ap=a+p*csa;
+            for (size_t i=0;i<mr;i++) Ap[i]=ap[i*rsa];
+            for (size_t i=mr;i<MR;i++) Ap[i]=T(0);
+        }
+    }
+}
+//
+//  Pack a kc x nc block of B into NR wide slivers, row by row within a sliver.
+//
+template <class T, size_t NR> void pack_B(size_t kc, size_t nc, const T* B, size_t rsb, size_t csb, T* Bp)
+{
+    for (size_t j0=0;j0<nc;j0+=NR)
+    {
+        size_t nr=std::min(NR,nc-j0);
+        const T* b=B+j0*csb;
+        for (size_t p=0;p<kc;p++,Bp+=NR)
+        {
+            const T* bp=b+p*rsb;
+            for (size_t j=0;j<nr;j++) Bp[j]=bp[j*csb];
+            for (size_t j=nr;j<NR;j++) Bp[j]=T(0);
+        }
+    }
+}
+
+//
+//  C(mr,nr) = alpha*Ap*Bp + beta*C(mr,nr) for one register block.  Ap and Bp are packed slivers.
+//  If beta==0, C is not read, so it can be uninitialized on entry.
+//
+template <class T, size_t MR, size_t NR> void micro_kernel(size_t kc, const T* __restrict Ap, const T* __restrict Bp,
+    T alpha, T beta, T* C, size_t rsc, size_t csc, size_t mr, size_t nr)
+{
+    T ab[NR][MR]={};
+    for (size_t p=0;p<kc;p++,Ap+=MR,Bp+=NR)
+        for (size_t j=0;j<NR;j++)
+            for (size_t i=0;i<MR;i++)
+                ab[j][i]+=Ap[i]*Bp[j];
+
+    for (size_t j=0;j<nr;j++)
+    {
+        T* c=C+j*csc;
+        if (beta==T(0))
+            for (size_t i=0;i<mr;i++) c[i*rsc]=alpha*ab[j][i];
+        else
+            for (size_t i=0;i<mr;i++) c[i*rsc]=alpha*ab[j][i]+beta*c[i*rsc];
+    }
+}
+
+//
+//  Packing buffers are reused between calls.  One set per thread, so the engine can be called
+//  concurrently on disjoint blocks of C.
+//
+template <class T> T* gemm_buffer(size_t n, size_t which)
+{
+    // Always on the heap, an arena would be gone before the thread is.
+    thread_local aligned_data<T> buffers[2]{aligned_data<T>(aligned_allocator<T>(std::pmr::new_delete_resource())),
+                                            aligned_data<T>(aligned_allocator<T>(std::pmr::new_delete_resource()))};
+    if (buffers[which].size()<n) buffers[which].resize(n);
+    return &buffers[which][0];
+}
+
+//
+//  C(m,n) = alpha*A(m,k)*B(k,n) + beta*C(m,n)
+//
+template <class T> void gemm(size_t m, size_t n, size_t k,
+    T alpha, const T* A, size_t rsa, size_t csa,
+             const T* B, size_t rsb, size_t csb,
+    T beta ,       T* C, size_t rsc, size_t csc)
+{
+    using bs=gemm_blocking<T>;
+    constexpr size_t MR=bs::MR, NR=bs::NR, KC=bs::KC, MC=bs::MC, NC=bs::NC;
+    if (m==0 || n==0) return;
+    if (k==0 || alpha==T(0))
+    {
+        for (size_t j=0;j<n;j++)
+            for (size_t i=0;i<m;i++)
+                C[i*rsc+j*csc] = beta==T(0) ? T(0) : beta*C[i*rsc+j*csc];
+        return;
+    }
+
+    T* Bp=gemm_buffer<T>(KC*((std::min(NC,n)+NR-1)/NR)*NR,0);
+    T* Ap=gemm_buffer<T>(KC*((std::min(MC,m)+MR-1)/MR)*MR,1);
+
+    for (size_t jc=0;jc<n;jc+=NC)
+    {
+        size_t nc=std::min(NC,n-jc);
+        for (size_t pc=0;pc<k;pc+=KC)
+        {
+            size_t kc=std::min(KC,k-pc);
+            T beta_pc= pc==0 ? beta : T(1); //Only scale C on the first pass through k.
+            pack_B<T,NR>(kc,nc,B+pc*rsb+jc*csb,rsb,csb,Bp);
+            for (size_t ic=0;ic<m;ic+=MC)
+            {
+                size_t mc=std::min(MC,m-ic);
+                pack_A<T,MR>(mc,kc,A+ic*rsa+pc*csa,rsa,csa,Ap);
+                for (size_t jr=0;jr<nc;jr+=NR)
+                {
+                    size_t nr=std::min(NR,nc-jr);
+                    for (size_t ir=0;ir<mc;ir+=MR)
+                    {
+                        size_t mr=std::min(MR,mc-ir);
+                        T* c=C+(ic+ir)*rsc+(jc+jr)*csc;
+                        micro_kernel<T,MR,NR>(kc,Ap+ir*kc,Bp+jr*kc,alpha,beta_pc,c,rsc,csc,mr,nr);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+//  y(m) = alpha*A(m,n)*x(n) + beta*y(m), x and y contiguous.  Column major A goes down the columns as axpys,
+//  row major A along the rows as dots, so either way A is read once with unit stride and nothing is packed.
+//
+template <class T> void gemv(size_t m, size_t n, T alpha, const T* A, size_t rsa, size_t csa, const T* x, T beta, T* y)
+{
+    if constexpr (simd::isSimdType<T>)
+    {
+        if (rsa==1)
+        {
+            for (size_t i=0;i<m;i++) y[i]= beta==T(0) ? T(0) : beta*y[i];
+            for (size_t j=0;j<n;j++) simd::axpy(alpha*x[j],A+j*csa,y,m);
+            return;
+        }
+        if (csa==1)
+        {
+            for (size_t i=0;i<m;i++)
+            {
+                T d=alpha*simd::dot(A+i*rsa,x,n);
+                y[i]= beta==T(0) ? d : d+beta*y[i];
+            }
+            return;
+        }
+    }
+    for (size_t i=0;i<m;i++)
+    {
+        T d(0);
+        for (size_t j=0;j<n;j++) d+=A[i*rsa+j*csa]*x[j];
+        y[i]= beta==T(0) ? alpha*d : alpha*d+beta*y[i];
+    }
+}
+
+//
+//  Same as gemm above, but C is cut into tiles that are handed out to the thread pool.
+//  Each tile is an independent gemm call with its own packing buffers.  Small products,
+//  where the threading overhead would dominate, just call gemm directly.
+//
+template <class T> void parallel_gemm(size_t m, size_t n, size_t k,
+    T alpha, const T* A, size_t rsa, size_t csa,
+             const T* B, size_t rsb, size_t csb,
+    T beta ,       T* C, size_t rsc, size_t csc)
+{
+    using bs=gemm_blocking<T>;
+    size_t nt=num_threads();
+    if (nt==1 || m*n*k<size_t(1)<<21)
+    {
+        gemm(m,n,k,alpha,A,rsa,csa,B,rsb,csb,beta,C,rsc,csc);
+        return;
+    }
+    // Halve the larger tile dimension until there are a few tiles per thread for the work stealing.
+    size_t mb=m, nb=n;
+    while (((m+mb-1)/mb)*((n+nb-1)/nb)<4*nt)
+    {
+        if (mb>=nb && mb>2*bs::MR) mb=(mb+1)/2;
+        else if (nb>2*bs::NR)      nb=(nb+1)/2;
+        else break;
+    }
+    mb=(mb+bs::MR-1)/bs::MR*bs::MR;
+    nb=(nb+bs::NR-1)/bs::NR*bs::NR;
+    size_t ntm=(m+mb-1)/mb, ntn=(n+nb-1)/nb;
+    parallel_for(ntm*ntn,[&](size_t t)
+    {
+        size_t i0=(t%ntm)*mb, j0=(t/ntm)*nb;
+        gemm(std::min(mb,m-i0),std::min(nb,n-j0),k,
+            alpha,A+i0*rsa,rsa,csa,
+                  B+j0*csb,rsb,csb,
+            beta ,C+i0*rsc+j0*csc,rsc,csc);
+    });
+}
+
+} //namespace matrix23::native
+
+namespace matrix23
+{
+//
+//  Optional external gemm, i.e. dgemm from blas, for big products.  Nothing is registered by default,
+//  so header only users never need to link blas.  set_blas_offload() in blas.hpp registers one.
+//  Register it before starting any threads that multiply matrices, it is not synchronized.
+//
+template <class T> struct gemm_offload
+{
+    typedef void (*gemm_t)(size_t m, size_t n, size_t k,
+        T alpha, const T* A, size_t rsa, size_t csa,
+                 const T* B, size_t rsb, size_t csb,
+        T beta ,       T* C, size_t rsc, size_t csc);
+    static inline gemm_t gemm=nullptr;
+    static inline size_t min_mnk=0; //Only offload when m*n*k>=min_mnk.
+};
+
+// The gemm used to materialize product views.  Same arguments as native::gemm.
+template <class T> void product_gemm(size_t m, size_t n, size_t k,
+    T alpha, const T* A, size_t rsa, size_t csa,
+             const T* B, size_t rsb, size_t csb,
+    T beta ,       T* C, size_t rsc, size_t csc)
+{
+    using offload=gemm_offload<T>;
+    if (offload::gemm && m*n*k>=offload::min_mnk)
+        offload::gemm(m,n,k,alpha,A,rsa,csa,B,rsb,csb,beta,C,rsc,csc);
+    else
+        native::parallel_gemm(m,n,k,alpha,A,rsa,csa,B,rsb,csb,beta,C,rsc,csc);
+}
+
+} //namespace matrix23
@@ -0,0 +1,150 @@
+// File: getrf.hpp  Native LU factorization with partial pivoting and triangular solves.
+#pragma once
+
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include "matrix23/gemm.hpp"
+
+//
+//  Column major, (pointer, ld), like lapack:
+//      getrf            A=P*L*U.  Recursive on the columns: factor the left half, update the right half with
+//                       trsm and a gemm, factor what is left of it.  Nearly all the work ends up in
+//                       parallel_gemm on big square blocks, and there is no block size to tune.
+//      trsm_lower_unit  B=L^-1*B, L unit lower.  Halves L and updates the lower half of B with a gemm.
+//      trsm_upper       B=U^-1*B, U upper.
+//      laswp            The row swaps of getrf on other columns.  Column blocks go to the thread pool.
+//  Pivots are 0 based, row i was swapped with row ipiv[i] in step i.
+//
+namespace matrix23::native
+{
+
+inline constexpr size_t getrf_leaf=16; //Panel columns factored one by one.
+inline constexpr size_t trsm_leaf =32;
+
+template <class T> void laswp(size_t n, T* A, size_t lda, size_t k1, size_t k2, const size_t* ipiv)
+{
+    if (n==0 || k2<=k1) return;
+    constexpr size_t nb=32; //Columns per pass, the rows being swapped stay in L1.
+    size_t nblock=(n+nb-1)/nb;
+    size_t ntask= n*(k2-k1)<(size_t(1)<<16) ? 1 : std::min(nblock,4*num_threads());
+    parallel_for(ntask,[&](size_t t)
+    {
+        for (size_t b=t;b<nblock;b+=ntask)
+        {
+            size_t j0=b*nb, j1=std::min(n,j0+nb);
+            for (size_t i=k1;i<k2;i++)
+                if (ipiv[i]!=i)
+                    for (size_t j=j0;j<j1;j++) std::swap(A[i+j*lda],A[ipiv[i]+j*lda]);
+        }
+    });
+}
+
+// B(m x n)=L^-1*B, L is m x m unit lower.
+template <class T> void trsm_lower_unit(size_t m, size_t n, const T* L, size_t ldl, T* B, size_t ldb)
+{
+    if (m==0 || n==0) return;
+    if (m<=trsm_leaf)
+    {
+        for (size_t j=0;j<n;j++)
+        {
+            T* b=B+j*ldb;
+            for (size_t k=0;k<m;k++)
+            {
+                T bk=b[k];
+                const T* lk=L+k*ldl;
+                if (bk!=T(0))
+                    for (size_t i=k+1;i<m;i++) b[i]-=bk*lk[i];
+            }
+        }
+        return;
+    }
+    size_t h=m/2;
+    trsm_lower_unit(h,n,L,ldl,B,ldb);
+    parallel_gemm(m-h,n,h,T(-1),L+h,size_t(1),ldl,B,size_t(1),ldb,T(1),B+h,size_t(1),ldb);
+    trsm_lower_unit(m-h,n,L+h+h*ldl,ldl,B+h,ldb);
+}
+
+// B(m x n)=U^-1*B, U is m x m upper.
+template <class T> void trsm_upper(size_t m, size_t n, const T* U, size_t ldu, T* B, size_t ldb)
+{
+    if (m==0 || n==0) return;
+    if (m<=trsm_leaf)
+    {
+        for (size_t j=0;j<n;j++)
+        {
+            T* b=B+j*ldb;
+            for (size_t k=m;k-->0;)
+            {
+                const T* uk=U+k*ldu;
+                b[k]/=uk[k];
+                T bk=b[k];
+                if (bk!=T(0))
+                    for (size_t i=0;i<k;i++) b[i]-=bk*uk[i];
+            }
+        }
+        return;
+    }
+    size_t h=m/2;
+    trsm_upper(m-h,n,U+h+h*ldu,ldu,B+h,ldb);
+    parallel_gemm(h,n,m-h,T(-1),U+h*ldu,size_t(1),ldu,B+h,size_t(1),ldb,T(1),B,size_t(1),ldb);
+    trsm_upper(h,n,U,ldu,B,ldb);
+}
+
+// One column at a time, for narrow panels.
+template <class T> size_t getf2(size_t m, size_t n, T* A, size_t lda, size_t* ipiv)
+{
+    using std::abs;
+    size_t info=0;
+    for (size_t j=0;j<std::min(m,n);j++)
+    {
+        T* aj=A+j*lda;
+        size_t p=j;
+        for (size_t i=j+1;i<m;i++)
+            if (abs(aj[i])>abs(aj[p])) p=i;
+        ipiv[j]=p;
+        if (aj[p]==T(0)) //The rest of the column is zero too, nothing to eliminate.
+        {
+            if (info==0) info=j+1;
+            continue;
+        }
+        if (p!=j)
+            for (size_t c=0;c<n;c++) std::swap(A[j+c*lda],A[p+c*lda]);
+        T r=T(1)/aj[j];
+        for (size_t i=j+1;i<m;i++) aj[i]*=r;
+        for (size_t c=j+1;c<n;c++)
+        {
+            T* ac=A+c*lda;
+            T f=ac[j];
+            if (f!=T(0))
+                for (size_t i=j+1;i<m;i++) ac[i]-=f*aj[i];
+        }
+    }
+    return info;
+}
+
+//
+//  LU of the m x n matrix A in place, L below the diagonal (unit diagonal not stored) and U on and above.
+//  ipiv needs min(m,n) entries.  Returns 0, or 1+ the first column with a zero pivot, U is then singular.
+//
+template <class T> size_t getrf(size_t m, size_t n, T* A, size_t lda, size_t* ipiv)
+{
+    size_t k=std::min(m,n);
+    if (k==0) return 0;
+    if (n<=getrf_leaf || k<2) return getf2(m,n,A,lda,ipiv);
+    size_t n1=k/2, n2=n-n1;
+    T* A12=A+n1*lda;
+    T* A22=A12+n1;
+    size_t info=getrf(m,n1,A,lda,ipiv); //[A11;A21]
+    laswp(n2,A12,lda,0,n1,ipiv);
+    trsm_lower_unit(n1,n2,A,lda,A12,lda);
+    parallel_gemm(m-n1,n2,n1,T(-1),A+n1,size_t(1),lda,A12,size_t(1),lda,T(1),A22,size_t(1),lda); //A22-=A21*A12
+    size_t info2=getrf(m-n1,n2,A22,lda,ipiv+n1);
+    if (info==0 && info2>0) info=info2+n1;
+    for (size_t i=n1;i<k;i++) ipiv[i]+=n1;
+    laswp(n1,A,lda,n1,k,ipiv); //The swaps of A22 on A21.
+    return info;
+}
+
+} //namespace matrix23::native
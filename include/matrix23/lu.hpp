@@ -0,0 +1,77 @@
+// File: lu.hpp  LU factorization with partial pivoting, and linear solves.
+#pragma once
+
+#include "matrix23/matrix.hpp"
+#include "matrix23/getrf.hpp"
+#include <vector>
+
+//
+//  LU<T> factors a full column major matrix as A=P*L*U with the native kernels in getrf.hpp, no lapack needed.
+//  Factor once, solve as often as needed:
+//      LU<double> lu(A);
+//      Vector<double> x=lu.solve(b);         //A*x=b
+//      FullMatrixCM<double> X=lu.solve(B);   //A*X=B, all columns at once through the blocked trsm
+//      x=solve(A,b);                          //One off
+//  A singular U is not an error when factoring, singular() says so and solve asserts on it.
+//
+namespace matrix23
+{
+
+template <class T> class LU
+{
+public:
+    explicit LU(FullMatrixCM<T> A) : lu(std::move(A)), ipiv(std::min(lu.nr(),lu.nc()))
+    {
+        auto s=lu.strided();
+        status=native::getrf(lu.nr(),lu.nc(),s.data,s.cs,ipiv.data());
+    }
+
+    // L below the diagonal (unit diagonal not stored), U on and above it.
+    const FullMatrixCM<T>& factors() const {return lu;}
+    // Row i was swapped with row pivots()[i] in step i, 0 based.
+    const std::vector<size_t>& pivots() const {return ipiv;}
+    // 0, or 1+ the first column with a zero pivot.
+    size_t info    () const {return status;}
+    bool   singular() const {return status!=0;}
+    T determinant() const
+    {
+        assert(lu.nr()==lu.nc());
+        T d(1);
+        for (size_t i=0;i<ipiv.size();i++) d*= ipiv[i]==i ? lu(i,i) : -lu(i,i);
+        return d;
+    }
+
+    void solve_in_place(FullMatrixCM<T>& B) const
+    {
+        assert(B.nr()==lu.nr());
+        auto s=B.strided();
+        solve_in_place(B.nc(),s.data,s.cs);
+    }
+    void solve_in_place(Vector<T>& b) const
+    {
+        assert(b.size()==lu.nr());
+        if (b.size()>0) solve_in_place(1,&*b.begin(),b.size());
+    }
+    FullMatrixCM<T> solve(FullMatrixCM<T> B) const {solve_in_place(B);return B;}
+    Vector<T>       solve(Vector<T>       b) const {solve_in_place(b);return b;}
+private:
+    // X=U^-1*L^-1*P^T*B for the n right hand sides in B.
+    void solve_in_place(size_t n, T* B, size_t ldb) const
+    {
+        assert(lu.nr()==lu.nc());
+        assert(!singular());
+        auto s=lu.strided();
+        size_t m=lu.nr();
+        native::laswp(n,B,ldb,0,m,ipiv.data());
+        native::trsm_lower_unit(m,n,s.data,s.cs,B,ldb);
+        native::trsm_upper     (m,n,s.data,s.cs,B,ldb);
+    }
+    FullMatrixCM<T> lu;
+    std::vector<size_t> ipiv;
+    size_t status;
+};
+
+template <class T> Vector<T>       solve(const FullMatrixCM<T>& A, Vector<T>       b) {return LU<T>(A).solve(std::move(b));}
+template <class T> FullMatrixCM<T> solve(const FullMatrixCM<T>& A, FullMatrixCM<T> B) {return LU<T>(A).solve(std::move(B));}
+
+} //namespace matrix23
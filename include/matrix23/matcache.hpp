@@ -0,0 +1,181 @@
+// File: matcache.hpp  Memoized rows and columns for nested lazy expressions.
+#pragma once
+
+#include "matrix23/matrix.hpp"
+#include "matrix23/aligned.hpp"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+//
+//  A product view computes a whole dot product for each element.  Used as an operand of another product,
+//  directly or inside a sum like (A*B+C)*D, each of its rows is evaluated again for every column of the
+//  outer product, so every level of nesting multiplies the work by n.  MatrixCacheView sits on such an
+//  operand and keeps the rows and columns it has evaluated, up to cache_budget() bytes per view.  Past that
+//  the oldest lines are dropped and evaluated again when needed.  The general op* puts one on operands
+//  with costly_elements, cached(m) does it by hand.
+//
+namespace matrix23
+{
+
+// Element access costs more than a lookup, i.e. a dot product.  Set for the product views in matmul.hpp.
+template <class M> constexpr bool costly_elements=false;
+template <isMatrix M, isMatrix Mb, class Op> constexpr bool costly_elements<MatrixBinOpView<M,Mb,Op>> =
+    costly_elements<std::remove_cvref_t<M>> || costly_elements<std::remove_cvref_t<Mb>>;
+template <isMatrix M, class Op> constexpr bool costly_elements<MatrixOpView<M,Op>> =costly_elements<std::remove_cvref_t<M>>;
+template <isMatrix M> constexpr bool costly_elements<MatrixTransposeView<M>> =costly_elements<std::remove_cvref_t<M>>;
+
+// Bytes each MatrixCacheView may hold.  0 turns caching off.
+inline std::atomic<size_t>& cache_budget_slot()
+{
+    static std::atomic<size_t> bytes=size_t(64)<<20;
+    return bytes;
+}
+inline size_t cache_budget() {return cache_budget_slot();}
+// Returns the previous budget.
+inline size_t set_cache_budget(size_t bytes) {return cache_budget_slot().exchange(bytes);}
+
+// A row or column as evaluated, i.e. the non zero part and where it sits.
+template <class T> struct cached_line
+{
+    iota_view indices;
+    aligned_data<T> data;
+};
+
+// A cached line.  Views of it share ownership, so dropping it from the cache doesn't pull it from under them.
+template <class T> class shared_slice : public std::ranges::view_base
+{
+public:
+    shared_slice() = default;
+    explicit shared_slice(std::shared_ptr<const cached_line<T>> _l) : l(std::move(_l)) {}
+    const T* data () const {return l ? l->data.data() : nullptr;}
+    const T* begin() const {return data();}
+    const T* end  () const {return data()+size();}
+    size_t   size () const {return l ? l->data.size() : 0;}
+private:
+    std::shared_ptr<const cached_line<T>> l;
+};
+
+template <class T> class line_cache
+{
+public:
+    typedef std::shared_ptr<const cached_line<T>> line_t;
+    explicit line_cache(size_t n) : lines(n) {}
+    ~line_cache() {for (auto& l:lines) delete l.load();}
+    line_cache(const line_cache&) = delete;
+    line_cache& operator=(const line_cache&) = delete;
+    // Line k, made by fill() unless it is held.  A held line is read without the mutex, readers only count
+    // themselves in while they copy it.  A dropped line is retired, and freed once no reader is counted.  The
+    // mutex guards filling and dropping.  fill() runs outside the lock so threads can fill different lines at once.
+    template <class F> line_t get(size_t k, F&& fill)
+    {
+        readers++;
+        const line_t* held=lines[k].load();
+        line_t l= held ? *held : nullptr;
+        readers--;
+        if (l) return l;
+        l=std::make_shared<const cached_line<T>>(fill());
+        size_t b=l->data.size()*sizeof(T), budget=cache_budget();
+        std::lock_guard lock(mutex);
+        if (const line_t* held=lines[k].load()) return *held; //Another thread got there first.
+        if (readers==0) retired.clear(); //Dropped before, no reader can still be copying them.
+        if (b>budget) return l;
+        while (bytes+b>budget)
+        {
+            size_t oldest=resident.front();
+            resident.pop_front();
+            retired.emplace_back(lines[oldest].exchange(nullptr));
+            bytes-=(*retired.back())->data.size()*sizeof(T);
+        }
+        lines[k].store(new line_t(l));
+        resident.push_back(k);
+        bytes+=b;
+        return l;
+    }
+private:
+    std::mutex mutex;
+    std::vector<std::atomic<const line_t*>> lines;
+    std::vector<std::unique_ptr<const line_t>> retired;
+    std::atomic<size_t> readers{0};
+    std::deque<size_t> resident; //Oldest first.
+    size_t bytes=0;
+};
+
+template <isMatrix M> class MatrixCacheView
+{
+public:
+    typedef std::remove_cvref_t<M>::value_type value_type;
+    explicit MatrixCacheView(const M& m) : s(std::make_shared<state>(m)) {}
+
+    value_type operator()(size_t i, size_t j) const
+    {
+        auto nz=s->m.shaper().nonzero_col_indexes(i);
+        if (nz.empty() || j<nz.front() || j>nz.back()) return value_type(0); //Structural zero, no row needed.
+        auto l=s->row(i);
+        assert(!l->indices.empty() && j>=l->indices.front() && j<=l->indices.back());
+        return l->data[j-l->indices.front()];
+    }
+    size_t size() const {return nr()*nc();}
+    size_t nr  () const {return s->m.nr();}
+    size_t nc  () const {return s->m.nc();}
+    // Lines are shared with the cache, so these stay valid after the view is gone.
+    auto rows() const
+    {
+        return std::views::iota(size_t(0),nr()) | std::views::transform([s=s](size_t i)
+        {
+            auto l=s->row(i);
+            return VectorView(shared_slice<value_type>(l),l->indices);
+        });
+    }
+    auto cols() const
+    {
+        return std::views::iota(size_t(0),nc()) | std::views::transform([s=s](size_t j)
+        {
+            auto l=s->col(j);
+            return VectorView(shared_slice<value_type>(l),l->indices);
+        });
+    }
+    auto packer() const {return s->m.packer();}
+    auto shaper() const {return s->m.shaper();}
+    bool reads(const storage_span& sp) const {return reads_from(s->m,sp);}
+private:
+    typedef std::shared_ptr<const cached_line<value_type>> line_t;
+    // Lines come from the resource that was current where the view was made, an arena only if the view is in it too.
+    // An arena is not thread safe, so only the thread it is current on allocates from it, pool workers filling
+    // lines at the same time use new/delete.
+    template <class V> static cached_line<value_type> materialize(const V& v, std::pmr::memory_resource* r)
+    {
+        if (r!=current_resource()) r=std::pmr::new_delete_resource();
+        cached_line<value_type> l{v.indices(),aligned_data<value_type>(aligned_allocator<value_type>(r))};
+        l.data.reserve(v.size());
+        for (auto x:v) l.data.push_back(x);
+        return l;
+    }
+    // Copies share the state, rows()/cols() hold on to it too.
+    struct state
+    {
+        explicit state(const M& _m) : m(_m), mrows(m.rows()), mcols(m.cols()), row_lines(m.nr()), col_lines(m.nc()), resource(current_resource()) {}
+        line_t row(size_t i) {return row_lines.get(i,[&] {return materialize(mrows[i],resource);});}
+        line_t col(size_t j) {return col_lines.get(j,[&] {return materialize(mcols[j],resource);});}
+
+        M m;
+        decltype(std::declval<const M&>().rows()) mrows;
+        decltype(std::declval<const M&>().cols()) mcols;
+        line_cache<value_type> row_lines,col_lines;
+        std::pmr::memory_resource* resource;
+    };
+    std::shared_ptr<state> s;
+};
+
+template <isMatrix M> auto cached(const M& m) {return MatrixCacheView<M>(m);}
+// m itself, or a cache on it if its elements are costly.
+template <isMatrix M> decltype(auto) cached_if_costly(const M& m)
+{
+    if constexpr (costly_elements<M>)
+        return MatrixCacheView<M>(m);
+    else
+        return (m);
+}
+
+} //namespace matrix23
@@ -0,0 +1,261 @@
+// File: matchain.hpp  Matrix chain products A*B*C*D evaluated in the cheapest order.
+#pragma once
+
+#include "matrix23/matmul.hpp"
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <variant>
+
+//
+//  Nesting product views, (A*B)*C, recomputes a row of A*B for every element of the result, so the cost
+//  grows exponentially with the length of the chain.  Instead, once a product of stored leaves (full,
+//  diagonal or band, see FactoredView) is multiplied again, the leaves are collected in a MatrixChainView.
+//  When it is assigned the order of the products is chosen by the classic dynamic programme over the
+//  dimensions, with costs that know diagonal and band factors are cheap.  For 10x100 * 100x5 * 5x50,
+//  (A*B)*C is 7500 multiply-adds and A*(B*C) is 75000.
+//  Each inner product is materialized once into a full, diagonal or band temporary, the outer product goes
+//  straight into the destination through the native kernels.
+//  Leaves are held by address, so like the other views a chain must not outlive its factors.
+//
+namespace matrix23
+{
+
+template <class T> using chain_leaf=std::variant<const FullMatrixCM<T>*,const FullMatrixRM<T>*,const DiagonalMatrix<T>*,const SBandMatrix<T>*>;
+
+// Storage of a leaf or a partial product as the cost model sees it.
+struct chain_kind
+{
+    enum kind_t {diagonal,band,full} kind;
+    size_t k; //bandwidth
+};
+template <class T> chain_kind kind_of(const chain_leaf<T>& l)
+{
+    return std::visit([]<class M>(const M* m) -> chain_kind
+    {
+        if constexpr (std::same_as<M,DiagonalMatrix<T>>) return {chain_kind::diagonal,0};
+        else if constexpr (std::same_as<M,SBandMatrix<T>>) return {chain_kind::band,m->bandwidth()};
+        else return {chain_kind::full,0};
+    },l);
+}
+inline chain_kind operator*(chain_kind a, chain_kind b)
+{
+    if (a.kind==chain_kind::full || b.kind==chain_kind::full) return {chain_kind::full,0};
+    if (a.kind==chain_kind::diagonal && b.kind==chain_kind::diagonal) return {chain_kind::diagonal,0};
+    return {chain_kind::band,a.k+b.k};
+}
+// Multiply-adds for (m x l)*(l x n) with factors of kind a and b.  Follows what chain_multiply does.
+inline double chain_cost(chain_kind a, chain_kind b, size_t m, size_t l, size_t n)
+{
+    double dm=m, dl=l, dn=n;
+    if (a.kind==chain_kind::full && b.kind==chain_kind::full) return dm*dl*dn;
+    if (a.kind==chain_kind::full) return dm*dn*(2*b.k+1); //Diagonal has k=0.
+    if (b.kind==chain_kind::full) return dm*dn*(2*a.k+1);
+    if (a.kind==chain_kind::diagonal && b.kind==chain_kind::diagonal) return dm;
+    return dm*(2*a.k+1)*(2*b.k+1);
+}
+
+// Packer of a product as the chain sees it.  MatrixProductPacker doesn't know the bandwidth of diagonal*band.
+template <isPacker A, isPacker B> auto chain_packer(const A& a, const B& b) {return MatrixProductPacker(a,b);}
+inline SBandPacker chain_packer(const DiagonalPacker& a, const SBandPacker& b) {return SBandPacker(a.nr(),b.bandwidth());}
+inline SBandPacker chain_packer(const SBandPacker& a, const DiagonalPacker& b) {return SBandPacker(a.nr(),a.bandwidth());}
+
+// Partial products of a chain.  A std::deque so the leaves pointing into it stay put.
+template <class T> using chain_temps=std::deque<std::variant<FullMatrixCM<T>,DiagonalMatrix<T>,SBandMatrix<T>>>;
+template <class T, class M> const M* keep(chain_temps<T>& temps, M&& m)
+{
+    return &std::get<std::remove_cvref_t<M>>(temps.emplace_back(std::move(m)));
+}
+template <class T> SBandMatrix<T> as_band(const DiagonalMatrix<T>& d)
+{
+    SBandMatrix<T> b(d.nr(),0,zero);
+    for (size_t i=0;i<d.nr();i++) b(i,i)=d(i,i);
+    return b;
+}
+
+//
+//  Calls f(x*y) with the product view of the two leaves.  Only pairs with a fast view get that far, row major
+//  full factors next to a full factor are copied column major first, so full*full always goes to gemm,
+//  and a diagonal next to a band becomes a band of width 0.
+//
+template <class T, class F> void chain_multiply(const chain_leaf<T>& x, const chain_leaf<T>& y, chain_temps<T>& temps, F&& f)
+{
+    std::visit([&]<class A, class B>(const A* a, const B* b)
+    {
+        constexpr bool a_full= std::same_as<A,FullMatrixCM<T>> || std::same_as<A,FullMatrixRM<T>>;
+        constexpr bool b_full= std::same_as<B,FullMatrixCM<T>> || std::same_as<B,FullMatrixRM<T>>;
+        if constexpr (std::same_as<A,FullMatrixRM<T>> && b_full)
+            chain_multiply<T>(keep(temps,FullMatrixCM<T>(*a)),y,temps,f);
+        else if constexpr (std::same_as<B,FullMatrixRM<T>> && a_full)
+            chain_multiply<T>(x,keep(temps,FullMatrixCM<T>(*b)),temps,f);
+        else if constexpr (std::same_as<A,DiagonalMatrix<T>> && std::same_as<B,SBandMatrix<T>>)
+            chain_multiply<T>(keep(temps,as_band(*a)),y,temps,f);
+        else if constexpr (std::same_as<A,SBandMatrix<T>> && std::same_as<B,DiagonalMatrix<T>>)
+            chain_multiply<T>(x,keep(temps,as_band(*b)),temps,f);
+        else
+            f((*a)*(*b));
+    },x,y);
+}
+// x*y stored in the cheapest of the temporary types.
+template <class T> chain_leaf<T> chain_product(const chain_leaf<T>& x, const chain_leaf<T>& y, chain_temps<T>& temps)
+{
+    chain_leaf<T> xy;
+    chain_multiply<T>(x,y,temps,[&](const auto& v)
+    {
+        using P=decltype(v.packer());
+        if constexpr (std::same_as<P,DiagonalPacker>)
+            xy=keep(temps,DiagonalMatrix<T>(v));
+        else if constexpr (std::same_as<P,SBandPacker>)
+            xy=keep(temps,SBandMatrix<T>(v));
+        else
+            xy=keep(temps,FullMatrixCM<T>(v));
+    });
+    return xy;
+}
+
+template <class T, isPacker P> class MatrixChainView
+{
+public:
+    typedef T value_type;
+    MatrixChainView(std::vector<chain_leaf<T>> _leaves, P _packer)
+    : leaves(std::move(_leaves)), itsPacker(_packer), itsResult(std::make_shared<result_t>()) {}
+
+    size_t size() const {return nr()*nc();}
+    size_t nr  () const {return itsPacker.nr();}
+    size_t nc  () const {return itsPacker.nc();}
+    P    packer() const {return itsPacker;}
+    auto shaper() const {return itsPacker.shaper();}
+    // Reading elements evaluates the whole chain once.
+    T operator()(size_t i, size_t j) const {return result()(i,j);}
+    auto rows() const {return result().rows();}
+    auto cols() const {return result().cols();}
+    bool reads(const storage_span& s) const
+    {
+        return std::ranges::any_of(leaves,[&](const chain_leaf<T>& l) {return std::visit([&](auto* m) {return m->reads(s);},l);});
+    }
+    const std::vector<chain_leaf<T>>& chain_leaves() const {return leaves;}
+    // Multiply-adds for the chosen order.
+    double cost() const {return order().cost[leaves.size()-1];}
+
+    // Called from Matrix::load and Matrix::update.  Matrix has already checked the leaves against c.
+    template <isPacker Pc, isShaper Sc, class D, isSymmetry Sym> void assign_to(Matrix<T,Pc,Sc,D,Sym>& c) const
+    {
+        evaluate([&](const auto& ab) {c.noalias()=ab;});
+    }
+    template <isPacker Pc, isShaper Sc, class D, isSymmetry Sym> void assign_to(Matrix<T,Pc,Sc,D,Sym>& c, T alpha, T beta) const
+    {
+        evaluate([&](const auto& ab) {c.update(alpha,ab,beta);});
+    }
+private:
+    // cost and split of sub chain i..j are at [i*n+j].
+    struct order_t
+    {
+        std::vector<double> cost;
+        std::vector<size_t> split;
+    };
+    order_t order() const
+    {
+        size_t n=leaves.size();
+        std::vector<size_t> d(n+1); //Leaf i is d[i] x d[i+1].
+        std::vector<chain_kind> kind(n*n);
+        order_t o{std::vector<double>(n*n,0.0),std::vector<size_t>(n*n,0)};
+        for (size_t i=0;i<n;i++)
+        {
+            std::visit([&](auto* m) {d[i]=m->nr(); d[i+1]=m->nc();},leaves[i]);
+            kind[i*n+i]=kind_of<T>(leaves[i]);
+        }
+        for (size_t len=2;len<=n;len++)
+            for (size_t i=0;i+len<=n;i++)
+            {
+                size_t j=i+len-1;
+                o.cost[i*n+j]=std::numeric_limits<double>::max();
+                for (size_t s=i;s<j;s++)
+                {
+                    double c=o.cost[i*n+s]+o.cost[(s+1)*n+j]+chain_cost(kind[i*n+s],kind[(s+1)*n+j],d[i],d[s+1],d[j+1]);
+                    if (c<o.cost[i*n+j]) {o.cost[i*n+j]=c; o.split[i*n+j]=s;}
+                }
+                kind[i*n+j]=kind[i*n+j-1]*kind[j*n+j]; //Same for any split.
+            }
+        return o;
+    }
+    chain_leaf<T> product(size_t i, size_t j, const order_t& o, chain_temps<T>& temps) const
+    {
+        if (i==j) return leaves[i];
+        size_t s=o.split[i*leaves.size()+j];
+        return chain_product<T>(product(i,s,o,temps),product(s+1,j,o,temps),temps);
+    }
+    // Calls store(x*y) for the outer product, the temporaries live until it returns.  A diagonal or band chain
+    // only ever ends in a product of the same packing.  The leaves are a variant, so the other pairs are still
+    // instantiated and can't be ruled out at compile time, reaching one is a bug and throws, asserts or not.
+    template <class F> void evaluate(F&& store) const
+    {
+        size_t n=leaves.size();
+        assert(n>=2);
+        order_t o=order();
+        size_t s=o.split[n-1];
+        chain_temps<T> temps;
+        chain_multiply<T>(product(0,s,o,temps),product(s+1,n-1,o,temps),temps,[&](const auto& ab)
+        {
+            constexpr bool full=!std::same_as<P,DiagonalPacker> && !std::same_as<P,SBandPacker>;
+            if constexpr (full || std::same_as<decltype(ab.packer()),P>)
+                store(ab);
+            else
+                throw std::logic_error("matrix23: chain product of unexpected packing");
+        });
+    }
+
+    typedef Matrix<T,P,decltype(std::declval<P>().shaper())> matrix_t;
+    struct result_t
+    {
+        std::once_flag once;
+        std::optional<matrix_t> m;
+    };
+    const matrix_t& result() const
+    {
+        std::call_once(itsResult->once,[this]
+        {
+            itsResult->m.emplace(itsPacker,none);
+            assign_to(*itsResult->m);
+        });
+        return *itsResult->m;
+    }
+
+    std::vector<chain_leaf<T>> leaves;
+    P itsPacker;
+    std::shared_ptr<result_t> itsResult; //Shared by copies, they have the same leaves.
+};
+
+template <class M> constexpr bool is_chain_part=false;
+template <class V, class Ma, class Mb> constexpr bool is_chain_part<FactoredView<V,Ma,Mb>> =true;
+template <class T, isPacker P> constexpr bool is_chain_part<MatrixChainView<T,P>> =true;
+template <class M> concept isChainPart = isMatrix<M> && is_chain_part<M>;
+template <class M> concept isChainOperand = isChainLeaf<M> || isChainPart<M>;
+
+template <isChainLeaf M> auto as_chain(const M& m)
+{
+    return MatrixChainView<typename M::value_type,decltype(m.packer())>({&m},m.packer());
+}
+template <class V, class Ma, class Mb> auto as_chain(const FactoredView<V,Ma,Mb>& v) {return as_chain(v.left())*as_chain(v.right());}
+template <class T, isPacker P> const MatrixChainView<T,P>& as_chain(const MatrixChainView<T,P>& c) {return c;}
+
+template <class T, isPacker Pa, isPacker Pb> auto operator*(const MatrixChainView<T,Pa>& a,const MatrixChainView<T,Pb>& b)
+{
+    assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
+    std::vector<chain_leaf<T>> leaves=a.chain_leaves();
+    leaves.insert(leaves.end(),b.chain_leaves().begin(),b.chain_leaves().end());
+    auto p=chain_packer(a.packer(),b.packer());
+    return MatrixChainView<T,decltype(p)>(std::move(leaves),p);
+}
+// Diagonal*band has no view of its own, as a chain of two it is evaluated as a band product.
+template <class T> auto operator*(const DiagonalMatrix<T>& a,const SBandMatrix<T>& b) {return as_chain(a)*as_chain(b);}
+template <class T> auto operator*(const SBandMatrix<T>& a,const DiagonalMatrix<T>& b) {return as_chain(a)*as_chain(b);}
+// (A*B)*C, A*(B*C), (A*B)*(C*D) ...  More constrained than the general op*, so these win.
+auto operator*(const isChainPart    auto& a,const isChainOperand auto& b) {return as_chain(a)*as_chain(b);}
+auto operator*(const isChainOperand auto& a,const isChainPart    auto& b) {return as_chain(a)*as_chain(b);}
+auto operator*(const isChainPart    auto& a,const isChainPart    auto& b) {return as_chain(a)*as_chain(b);}
+
+} //namespace matrix23
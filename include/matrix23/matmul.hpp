@@ -2,11 +2,17 @@
 #pragma once
 
 #include "matrix23/matrix.hpp"
+#include "matrix23/gemm.hpp"
+#include "matrix23/bandmm.hpp"
+#include "matrix23/trmm.hpp"
+#include "matrix23/symmm.hpp"
+#include "matrix23/fixedmm.hpp"
+#include "matrix23/matcache.hpp"
 
 //
 //  The requirements we want to meet are:
 //      1) Support all combinations shapes, packings and symmetries.
-//      2) Support chained operations A*B*C*D without creation of temporaries.  (lazy eval)
+//      2) Support chained operations A*B*C*D without creation of temporaries.  (lazy eval, see matchain.hpp)
 //      3) Support mixed element types Matrix<double>*Matrix<std::complex<float>>.
 //      4) Don't waste time on definite zeros for triangular, band and diagonal matrices
 //      5) propagate packings and shapes corretly.  For example full=upper*lower, upper=upper*upper
@@ -46,6 +52,8 @@ template <isPacker P> struct MatrixProductPackerType<P,DiagonalPacker> {typedef
 template <isPacker P> struct MatrixProductPackerType<DiagonalPacker,P> {typedef P packer_t;};
 template <> struct MatrixProductPackerType<FullPackerCM,FullPackerCM> {typedef FullPackerCM packer_t;};
 template <> struct MatrixProductPackerType<FullPackerRM,FullPackerRM> {typedef FullPackerRM packer_t;};
+template <> struct MatrixProductPackerType<FullPackerCM,FullPackerRM> {typedef FullPackerCM packer_t;}; //Mixed layouts come back column major.
+template <> struct MatrixProductPackerType<FullPackerRM,FullPackerCM> {typedef FullPackerCM packer_t;};
 template <> struct MatrixProductPackerType<DiagonalPacker,FullPackerCM> {typedef FullPackerCM packer_t;};
 template <> struct MatrixProductPackerType<FullPackerCM,DiagonalPacker> {typedef FullPackerCM packer_t;};
 template <> struct MatrixProductPackerType<DiagonalPacker,FullPackerRM> {typedef FullPackerRM packer_t;};
@@ -55,7 +63,16 @@ template <> struct MatrixProductPackerType<UpperTriangularPackerCM,UpperTriangul
 template <> struct MatrixProductPackerType<LowerTriangularPackerCM,LowerTriangularPackerCM> {typedef LowerTriangularPackerCM packer_t;};
 template <> struct MatrixProductPackerType<UpperTriangularPackerCM,LowerTriangularPackerCM> {typedef FullPackerCM packer_t;};
 template <> struct MatrixProductPackerType<LowerTriangularPackerCM,UpperTriangularPackerCM> {typedef FullPackerCM packer_t;};
+template <> struct MatrixProductPackerType<UpperTriangularPackerRM,UpperTriangularPackerRM> {typedef UpperTriangularPackerRM packer_t;};
+template <> struct MatrixProductPackerType<LowerTriangularPackerRM,LowerTriangularPackerRM> {typedef LowerTriangularPackerRM packer_t;};
+template <> struct MatrixProductPackerType<UpperTriangularPackerRM,LowerTriangularPackerRM> {typedef FullPackerRM packer_t;};
+template <> struct MatrixProductPackerType<LowerTriangularPackerRM,UpperTriangularPackerRM> {typedef FullPackerRM packer_t;};
 template <> struct MatrixProductPackerType<SBandPacker,SBandPacker> {typedef SBandPacker packer_t;}; //Need to add the ks somehow.
+template <size_t M, size_t K, size_t N> struct MatrixProductPackerType<FixedPackerCM<M,K>,FixedPackerCM<K,N>> {typedef FixedPackerCM<M,N> packer_t;};
+template <size_t M, size_t N> struct MatrixProductPackerType<FixedPackerCM<M,N>,FullPackerCM> {typedef FullPackerCM packer_t;}; //Fixed with dynamic is dynamic.
+template <size_t M, size_t N> struct MatrixProductPackerType<FullPackerCM,FixedPackerCM<M,N>> {typedef FullPackerCM packer_t;};
+template <size_t M, size_t N> struct MatrixProductPackerType<FixedPackerCM<M,N>,FullPackerRM> {typedef FullPackerCM packer_t;};
+template <size_t M, size_t N> struct MatrixProductPackerType<FullPackerRM,FixedPackerCM<M,N>> {typedef FullPackerCM packer_t;};
 
 
 template <isShaper P1, isShaper P2> struct MatrixProductShaperType;
@@ -73,6 +90,9 @@ template <> struct MatrixProductShaperType<LowerTriangularShaper,LowerTriangular
 template <> struct MatrixProductShaperType<UpperTriangularShaper,LowerTriangularShaper> {typedef FullShaper shaper_t;};
 template <> struct MatrixProductShaperType<LowerTriangularShaper,UpperTriangularShaper> {typedef FullShaper shaper_t;};
 template <> struct MatrixProductShaperType<SBandShaper,SBandShaper> {typedef SBandShaper shaper_t;}; //Need to add the ks somehow.
+template <size_t M, size_t K, size_t N> struct MatrixProductShaperType<FixedShaper<M,K>,FixedShaper<K,N>> {typedef FixedShaper<M,N> shaper_t;};
+template <size_t M, size_t N> struct MatrixProductShaperType<FixedShaper<M,N>,FullShaper> {typedef FullShaper shaper_t;};
+template <size_t M, size_t N> struct MatrixProductShaperType<FullShaper,FixedShaper<M,N>> {typedef FullShaper shaper_t;};
 //
 //  Create product packers and shapers.
 //
@@ -140,15 +160,62 @@ public:
     }
     P packer() const {return itsPacker;}
     S shaper() const {return itsShaper;}
+    // Storage of the factors, so Matrix::operator= can spot C=A*C.  Factors that are views themselves are unknown.
+    template <class Ma, class Mb> void set_operands(const Ma& a, const Mb& b) {a_src=storage_of(a); b_src=storage_of(b);}
+    bool reads(const storage_span& s) const {return a_src.overlaps(s) || b_src.overlaps(s);}
+
+    // Called from Matrix::load.  C is cut into blocks of columns which are filled in parallel.
+    // Symmetric destinations are left to the serial load because they check (i,j) against (j,i).
+    template <class T, isPacker Pc, isShaper Sc, class D> void assign_to(Matrix<T,Pc,Sc,D,NoSymmetry<D,Pc>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        Pc pc=c.packer();
+        size_t ntask= nr()*nc()<64*64 ? 1 : std::min(nc(),4*num_threads());
+        size_t nb=(nc()+ntask-1)/ntask;
+        parallel_for(ntask,[&](size_t t)
+        {
+            for (size_t j=t*nb;j<std::min(nc(),(t+1)*nb);j++)
+                for (size_t i=0;i<nr();i++)
+                    if (pc.is_stored(i,j)) c(i,j)=(*this)(i,j);
+        });
+    }
 
 protected:
     R a_rows; //a as a range fo rows.
     C b_cols; //b as a range of cols.
     P itsPacker; //packing for the product.
     S itsShaper; // shape for the product
+    storage_span a_src,b_src;
 };
 
+// Returns v after recording where its factors are stored.
+template <class V, class Ma, class Mb> V reading(V v, const Ma& a, const Mb& b)
+{
+    v.set_operands(a,b);
+    return v;
+}
+
+//
+//  Products of two stored leaves (full, diagonal or band) also remember the leaves themselves, so that
+//  multiplying the product again starts a MatrixChainView (matchain.hpp) instead of nesting views.
+//
+template <class M> concept isChainLeaf = isMatrix<M> &&
+    (std::same_as<M,FullMatrixCM  <typename M::value_type>> || std::same_as<M,FullMatrixRM<typename M::value_type>> ||
+     std::same_as<M,DiagonalMatrix<typename M::value_type>> || std::same_as<M,SBandMatrix <typename M::value_type>>);
+template <class V, isChainLeaf Ma, isChainLeaf Mb> class FactoredView : public V
+{
+public:
+    FactoredView(V v, const Ma& a, const Mb& b) : V(std::move(v)), a_leaf(&a), b_leaf(&b) {}
+    const Ma& left () const {return *a_leaf;}
+    const Mb& right() const {return *b_leaf;}
+private:
+    const Ma* a_leaf;
+    const Mb* b_leaf;
+};
+template <class V, class Ma, class Mb> FactoredView<V,Ma,Mb> factored(V v, const Ma& a, const Mb& b) {return {std::move(v),a,b};}
+
 // Special version for full matrix products.  Skips indice interesction analysis the row[i]*col[j] dot products.
+// When assigned to a full matrix the whole product is materialized by the native gemm engine instead.
 template <std::ranges::viewable_range R, std::ranges::viewable_range C> class FullMatrixCMProductView
 : MatrixProductView<R,C,FullPackerCM,FullShaper>
 {
@@ -163,12 +230,16 @@ public:
     using Base::cols;
     using Base::packer;
     using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+    using Base::assign_to; //Non full destinations.
     //protected    
     using Base::a_rows;
     using Base::b_cols;
 
-   FullMatrixCMProductView(const R& rows, const C& cols,FullPackerCM packer, FullShaper shaper )
-    : Base(rows,cols,packer,shaper), i_cache(nr()) , ai_cache(0) {}
+    FullMatrixCMProductView(const R& rows, const C& cols,FullPackerCM packer, FullShaper shaper,
+        const value_type* a, size_t ld_a, const value_type* b, size_t ld_b, size_t k)
+    : Base(rows,cols,packer,shaper), i_cache(nr()) , ai_cache(0), a_data(a), b_data(b), lda(ld_a), ldb(ld_b), nk(k) {}
     value_type operator()(size_t i, size_t j) const
     {
         if (i!=i_cache)
@@ -182,19 +253,557 @@ public:
         }
         return inner_product(ai_cache,b_cols[j]); //Skip all indices intersections and checking
     }
+    // Called from Matrix::load.  C can be column or row major, the engine only needs the strides.
+    // Big products go to blas instead if set_blas_offload() was called.
+    template <isPacker P, isShaper S, class D> requires std::same_as<P,FullPackerCM> || std::same_as<P,FullPackerRM>
+    void assign_to(Matrix<value_type,P,S,D,NoSymmetry<D,P>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        P pc=c.packer();
+        product_gemm(nr(),nc(),nk,value_type(1),a_data,1,lda,b_data,1,ldb,value_type(0),&*c.begin(),pc.row_stride(),pc.col_stride());
+    }
+    // c=alpha*A*B+beta*c from Matrix::update, so C+=A*B needs no temporary.
+    template <isPacker P, isShaper S, class D> requires std::same_as<P,FullPackerCM> || std::same_as<P,FullPackerRM>
+    void assign_to(Matrix<value_type,P,S,D,NoSymmetry<D,P>>& c, value_type alpha, value_type beta) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        P pc=c.packer();
+        product_gemm(nr(),nc(),nk,alpha,a_data,1,lda,b_data,1,ldb,beta,&*c.begin(),pc.row_stride(),pc.col_stride());
+    }
+    // Straight into a block of a full matrix, from SubMatrixView::load.
+    void assign_to(strided_data<value_type> c, value_type alpha, value_type beta) const
+    {
+        if (nr()==0 || nc()==0) return;
+        product_gemm(nr(),nc(),nk,alpha,a_data,1,lda,b_data,1,ldb,beta,c.data,c.rs,c.cs);
+    }
 
 private:
     mutable size_t i_cache;
     mutable default_data_type<value_type> ai_cache;
+    const value_type* a_data; //A and B are column major with leading dimensions lda, ldb.
+    const value_type* b_data;
+    size_t lda,ldb;
+    size_t nk;
 };
 
-// general overloaded op* for matricies.
+// Diagonal*Diagonal.  Only the diagonals meet so the product is an O(N) elementwise multiply.
+template <std::ranges::viewable_range R, std::ranges::viewable_range C> class DiagonalMatrixProductView
+: MatrixProductView<R,C,DiagonalPacker,DiagonalShaper>
+{
+public:
+    using Base=MatrixProductView<R,C,DiagonalPacker,DiagonalShaper>;
+    using value_type=Base::value_type;
+    using Base::nr;
+    using Base::nc;
+    using Base::rows;
+    using Base::cols;
+    using Base::packer;
+    using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+    using Base::assign_to; //Non diagonal destinations.
+
+    DiagonalMatrixProductView(const R& rows, const C& cols,DiagonalPacker packer, DiagonalShaper shaper, const value_type* a, const value_type* b, size_t n)
+    : Base(rows,cols,packer,shaper), a_data(a), b_data(b), nd(n) {}
+    value_type operator()(size_t i, size_t j) const
+    {
+        return i==j && i<nd ? a_data[i]*b_data[i] : value_type(0);
+    }
+    template <class D> void assign_to(Matrix<value_type,DiagonalPacker,DiagonalShaper,D,NoSymmetry<D,DiagonalPacker>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        for (size_t i=0;i<c.size();i++)
+            c(i,i)= i<nd ? a_data[i]*b_data[i] : value_type(0);
+    }
+
+private:
+    const value_type* a_data;
+    const value_type* b_data;
+    size_t nd; //# of diagonal elements stored by both a and b.
+};
+
+// Diagonal*Full (Left=true) and Full*Diagonal (Left=false) just scale the rows or columns of the full matrix.
+// Assigning to a full matrix streams through B and C once, in C's storage order.
+template <std::ranges::viewable_range R, std::ranges::viewable_range C, isPacker P, bool Left> class DiagonalScaledMatrixView
+: MatrixProductView<R,C,P,FullShaper>
+{
+public:
+    using Base=MatrixProductView<R,C,P,FullShaper>;
+    using value_type=Base::value_type;
+    using Base::nr;
+    using Base::nc;
+    using Base::rows;
+    using Base::cols;
+    using Base::packer;
+    using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+    using Base::assign_to; //Non full destinations.
+
+    // d,nd is the diagonal.  b,rsb,csb is the full matrix as (pointer, row stride, col stride).
+    DiagonalScaledMatrixView(const R& rows, const C& cols,P packer, FullShaper shaper, const value_type* d, size_t n,
+        const value_type* b, size_t rs, size_t cs)
+    : Base(rows,cols,packer,shaper), d_data(d), nd(n), b_data(b), rsb(rs), csb(cs) {}
+    value_type operator()(size_t i, size_t j) const
+    {
+        if constexpr (Left)
+            return i<nd ? d_data[i]*b(i,j) : value_type(0);
+        else
+            return j<nd ? b(i,j)*d_data[j] : value_type(0);
+    }
+    template <isPacker Pc, class D> requires std::same_as<Pc,FullPackerCM> || std::same_as<Pc,FullPackerRM>
+    void assign_to(Matrix<value_type,Pc,FullShaper,D,NoSymmetry<D,Pc>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        Pc pc=c.packer();
+        value_type* cd=&*c.begin();
+        size_t rsc=pc.row_stride(), csc=pc.col_stride();
+        bool by_cols= rsc==1;
+        size_t nouter= by_cols ? nc() : nr();
+        size_t ntask= nr()*nc()<64*64 ? 1 : std::min(nouter,4*num_threads());
+        size_t nb=(nouter+ntask-1)/ntask;
+        parallel_for(ntask,[&](size_t t)
+        {
+            for (size_t o=t*nb;o<std::min(nouter,(t+1)*nb);o++)
+                if (by_cols)
+                    scale_col(o,cd+o*csc,rsc);
+                else
+                    scale_row(o,cd+o*rsc,csc);
+        });
+    }
+
+private:
+    value_type b(size_t i, size_t j) const {return b_data[i*rsb+j*csb];}
+    // Fill column j of C, c points at C(0,j) and s is the distance between rows.
+    void scale_col(size_t j, value_type* c, size_t s) const
+    {
+        const value_type* bj=b_data+j*csb;
+        if constexpr (Left)
+        {
+            for (size_t i=0;i<nd;i++) c[i*s]=d_data[i]*bj[i*rsb];
+            for (size_t i=nd;i<nr();i++) c[i*s]=value_type(0);
+        }
+        else if (j<nd)
+        {
+            value_type dj=d_data[j];
+            for (size_t i=0;i<nr();i++) c[i*s]=bj[i*rsb]*dj;
+        }
+        else
+            for (size_t i=0;i<nr();i++) c[i*s]=value_type(0);
+    }
+    // Fill row i of C, c points at C(i,0) and s is the distance between columns.
+    void scale_row(size_t i, value_type* c, size_t s) const
+    {
+        const value_type* bi=b_data+i*rsb;
+        if constexpr (!Left)
+        {
+            for (size_t j=0;j<nd;j++) c[j*s]=bi[j*csb]*d_data[j];
+            for (size_t j=nd;j<nc();j++) c[j*s]=value_type(0);
+        }
+        else if (i<nd)
+        {
+            value_type di=d_data[i];
+            for (size_t j=0;j<nc();j++) c[j*s]=di*bi[j*csb];
+        }
+        else
+            for (size_t j=0;j<nc();j++) c[j*s]=value_type(0);
+    }
+
+    const value_type* d_data;
+    size_t nd; //# of stored diagonal elements.
+    const value_type* b_data;
+    size_t rsb,csb;
+};
+
+// SBand*SBand.  Evaluated along the band diagonals by native::sband_sband, O(n*ka*kb) instead of O(n^2) intersections.
+template <std::ranges::viewable_range R, std::ranges::viewable_range C> class SBandMatrixProductView
+: MatrixProductView<R,C,SBandPacker,SBandShaper>
+{
+public:
+    using Base=MatrixProductView<R,C,SBandPacker,SBandShaper>;
+    using value_type=Base::value_type;
+    using Base::nr;
+    using Base::nc;
+    using Base::rows;
+    using Base::cols;
+    using Base::packer;
+    using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+    using Base::assign_to; //Non band destinations.
+
+    SBandMatrixProductView(const R& rows, const C& cols,SBandPacker packer, SBandShaper shaper,
+        const value_type* a, size_t _ka, const value_type* b, size_t _kb)
+    : Base(rows,cols,packer,shaper), a_data(a), b_data(b), ka(_ka), kb(_kb) {}
+    value_type operator()(size_t i, size_t j) const
+    {
+        size_t n=nr();
+        size_t l0=std::max(native::band_first(i,ka),native::band_first(j,kb));
+        size_t l1=std::min(native::band_last (i,ka,n),native::band_last (j,kb,n));
+        value_type t(0);
+        for (size_t l=l0;l<=l1;l++)
+            t+=a_data[l*(2*ka+1)+ka+i-l]*b_data[j*(2*kb+1)+kb+l-j];
+        return t;
+    }
+    template <class D> void assign_to(Matrix<value_type,SBandPacker,SBandShaper,D,NoSymmetry<D,SBandPacker>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        native::sband_sband(nr(),a_data,ka,b_data,kb,&*c.begin(),c.packer().bandwidth());
+    }
+
+private:
+    const value_type* a_data;
+    const value_type* b_data;
+    size_t ka,kb;
+};
+
+// SBand*Full (Left=true) and Full*SBand (Left=false).  Each element of C only needs the band part of a row/col.
+template <std::ranges::viewable_range R, std::ranges::viewable_range C, isPacker P, bool Left> class SBandFullProductView
+: MatrixProductView<R,C,P,FullShaper>
+{
+public:
+    using Base=MatrixProductView<R,C,P,FullShaper>;
+    using value_type=Base::value_type;
+    using Base::nr;
+    using Base::nc;
+    using Base::rows;
+    using Base::cols;
+    using Base::packer;
+    using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+    using Base::assign_to; //Non full destinations.
+
+    // s,k is the band matrix.  f,rsf,csf is the full matrix as (pointer, row stride, col stride).
+    SBandFullProductView(const R& rows, const C& cols,P packer, FullShaper shaper, const value_type* s, size_t _k,
+        const value_type* f, size_t rs, size_t cs)
+    : Base(rows,cols,packer,shaper), s_data(s), k(_k), f_data(f), rsf(rs), csf(cs) {}
+    value_type operator()(size_t i, size_t j) const
+    {
+        value_type t(0);
+        if constexpr (Left)
+            for (size_t l=native::band_first(i,k);l<=native::band_last(i,k,nr());l++)
+                t+=s_data[l*(2*k+1)+k+i-l]*f_data[l*rsf+j*csf];
+        else
+            for (size_t l=native::band_first(j,k);l<=native::band_last(j,k,nc());l++)
+                t+=f_data[i*rsf+l*csf]*s_data[j*(2*k+1)+k+l-j];
+        return t;
+    }
+    template <isPacker Pc, class D> requires std::same_as<Pc,FullPackerCM> || std::same_as<Pc,FullPackerRM>
+    void assign_to(Matrix<value_type,Pc,FullShaper,D,NoSymmetry<D,Pc>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        Pc pc=c.packer();
+        if constexpr (Left)
+            native::sband_full(nr(),nc(),s_data,k,f_data,rsf,csf,&*c.begin(),pc.row_stride(),pc.col_stride());
+        else
+            native::full_sband(nr(),nc(),f_data,rsf,csf,s_data,k,&*c.begin(),pc.row_stride(),pc.col_stride());
+    }
+
+private:
+    const value_type* s_data;
+    size_t k;
+    const value_type* f_data;
+    size_t rsf,csf;
+};
+
+// Symmetric*Full (Left=true) and Full*Symmetric (Left=false), symmetric in packed upper storage.  Assigned to a
+// full matrix it goes to native::symm, which reads each stored element once for both halves.
+template <std::ranges::viewable_range R, std::ranges::viewable_range C, isPacker P, bool Left> class SymmetricFullProductView
+: MatrixProductView<R,C,P,FullShaper>
+{
+public:
+    using Base=MatrixProductView<R,C,P,FullShaper>;
+    using value_type=Base::value_type;
+    using Base::nr;
+    using Base::nc;
+    using Base::rows;
+    using Base::cols;
+    using Base::packer;
+    using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+    using Base::assign_to; //Non full destinations.
+
+    // s is the packed symmetric matrix, n x n.  f,rsf,csf is the full matrix as (pointer, row stride, col stride).
+    SymmetricFullProductView(const R& rows, const C& cols,P packer, FullShaper shaper, const value_type* s, size_t _n,
+        const value_type* f, size_t rs, size_t cs)
+    : Base(rows,cols,packer,shaper), s_data(s), n(_n), f_data(f), rsf(rs), csf(cs) {}
+    value_type operator()(size_t i, size_t j) const
+    {
+        value_type t(0);
+        if constexpr (Left)
+            for (size_t l=0;l<n;l++) t+=sym(i,l)*f_data[l*rsf+j*csf];
+        else
+            for (size_t l=0;l<n;l++) t+=f_data[i*rsf+l*csf]*sym(l,j);
+        return t;
+    }
+    template <isPacker Pc, class D> requires std::same_as<Pc,FullPackerCM> || std::same_as<Pc,FullPackerRM>
+    void assign_to(Matrix<value_type,Pc,FullShaper,D,NoSymmetry<D,Pc>>& c) const
+    {
+        assign_to(c,value_type(1),value_type(0));
+    }
+    template <isPacker Pc, class D> requires std::same_as<Pc,FullPackerCM> || std::same_as<Pc,FullPackerRM>
+    void assign_to(Matrix<value_type,Pc,FullShaper,D,NoSymmetry<D,Pc>>& c, value_type alpha, value_type beta) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        Pc pc=c.packer();
+        if constexpr (Left)
+            native::symm(nr(),nc(),alpha,s_data,f_data,rsf,csf,beta,&*c.begin(),pc.row_stride(),pc.col_stride());
+        else
+            native::symm(nc(),nr(),alpha,s_data,f_data,csf,rsf,beta,&*c.begin(),pc.col_stride(),pc.row_stride());
+    }
+    void assign_to(strided_data<value_type> c, value_type alpha, value_type beta) const
+    {
+        if (nr()==0 || nc()==0) return;
+        if constexpr (Left)
+            native::symm(nr(),nc(),alpha,s_data,f_data,rsf,csf,beta,c.data,c.rs,c.cs);
+        else
+            native::symm(nc(),nr(),alpha,s_data,f_data,csf,rsf,beta,c.data,c.cs,c.rs);
+    }
+
+private:
+    value_type sym(size_t i, size_t j) const {return i<=j ? s_data[i+j*(j+1)/2] : s_data[j+i*(i+1)/2];}
+    const value_type* s_data;
+    size_t n;
+    const value_type* f_data;
+    size_t rsf,csf;
+};
+
+//
+//  A*~B and ~A*B with column major A and B.  The transposed operand is just read with swapped strides.
+//  When both operands hold the same data the product is symmetric, so only its upper triangle is
+//  multiplied (native::syrk) and SymmetricMatrixCM destinations are filled in packed form.
+//
+template <std::ranges::viewable_range R, std::ranges::viewable_range C> class FullTransposeProductView
+: MatrixProductView<R,C,FullPackerCM,FullShaper>
+{
+public:
+    using Base=MatrixProductView<R,C,FullPackerCM,FullShaper>;
+    using value_type=Base::value_type;
+    using Base::nr;
+    using Base::nc;
+    using Base::rows;
+    using Base::cols;
+    using Base::packer;
+    using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+    using Base::assign_to; //Other destinations.
+
+    // a and b are (pointer, row stride, col stride) of the two factors, sym says a*b is a*a^T.
+    FullTransposeProductView(const R& rows, const C& cols,FullPackerCM packer, FullShaper shaper,
+        const value_type* a, size_t rs_a, size_t cs_a, const value_type* b, size_t rs_b, size_t cs_b, size_t k, bool sym)
+    : Base(rows,cols,packer,shaper), a_data(a), b_data(b), rsa(rs_a), csa(cs_a), rsb(rs_b), csb(cs_b), nk(k), symmetric(sym) {}
+    value_type operator()(size_t i, size_t j) const
+    {
+        value_type t(0);
+        for (size_t l=0;l<nk;l++) t+=a_data[i*rsa+l*csa]*b_data[l*rsb+j*csb];
+        return t;
+    }
+    template <isPacker P, isShaper S, class D> requires std::same_as<P,FullPackerCM> || std::same_as<P,FullPackerRM>
+    void assign_to(Matrix<value_type,P,S,D,NoSymmetry<D,P>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        P pc=c.packer();
+        if (symmetric)
+            native::syrk(nr(),nk,a_data,rsa,csa,&*c.begin(),pc.row_stride(),pc.col_stride());
+        else
+            product_gemm(nr(),nc(),nk,value_type(1),a_data,rsa,csa,b_data,rsb,csb,value_type(0),&*c.begin(),pc.row_stride(),pc.col_stride());
+    }
+    // Updates always take the gemm path, syrk only writes and mirrors.
+    template <isPacker P, isShaper S, class D> requires std::same_as<P,FullPackerCM> || std::same_as<P,FullPackerRM>
+    void assign_to(Matrix<value_type,P,S,D,NoSymmetry<D,P>>& c, value_type alpha, value_type beta) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        if (c.size()==0) return;
+        P pc=c.packer();
+        product_gemm(nr(),nc(),nk,alpha,a_data,rsa,csa,b_data,rsb,csb,beta,&*c.begin(),pc.row_stride(),pc.col_stride());
+    }
+    // A block of a full matrix, from SubMatrixView::load.
+    void assign_to(strided_data<value_type> c, value_type alpha, value_type beta) const
+    {
+        if (nr()==0 || nc()==0) return;
+        product_gemm(nr(),nc(),nk,alpha,a_data,rsa,csa,b_data,rsb,csb,beta,c.data,c.rs,c.cs);
+    }
+    template <class D> void assign_to(Matrix<value_type,UpperTriangularPackerCM,FullShaper,D,Symmetric<D,UpperTriangularPackerCM>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        assert(symmetric && "Product assigned to a symmetric matrix is not symmetric");
+        if (c.size()==0) return;
+        if (symmetric)
+            native::syrk_packed(nr(),nk,a_data,rsa,csa,&*c.begin());
+        else
+            for (size_t j=0;j<nc();j++)
+                for (size_t i=0;i<=j;i++) c(i,j)=(*this)(i,j);
+    }
+
+private:
+    const value_type* a_data;
+    const value_type* b_data;
+    size_t rsa,csa,rsb,csb;
+    size_t nk;
+    bool symmetric;
+};
+
+//
+//  Triangular products.  Any mix of upper, lower and full shapes, with packed or full storage, where at
+//  least one operand is triangular.  Only stored matrices qualify, the view reads their storage directly.
+//  Full storage of a full shape goes to native::triangular_gemm in place, as (pointer, strides).  Packed
+//  storage, and triangles in full storage whose other half may hold anything, are expanded once to column
+//  major with explicit zeros, copying only the stored shape.
+//
+template <class T, isPacker P, isShaper S, class D, isSymmetry Sym> std::true_type is_stored_matrix(const Matrix<T,P,S,D,Sym>&);
+std::false_type is_stored_matrix(...);
+template <class M> concept isStoredMatrix = decltype(is_stored_matrix(std::declval<const M&>()))::value;
+
+template <isShaper S> constexpr native::shape triangular_shape =native::shape::full;
+template <> inline constexpr native::shape triangular_shape<UpperTriangularShaper> =native::shape::upper;
+template <> inline constexpr native::shape triangular_shape<LowerTriangularShaper> =native::shape::lower;
+
+template <class M> using packer_t=decltype(std::declval<const M&>().packer());
+template <class M> using shaper_t=decltype(std::declval<const M&>().shaper());
+
+template <class M> concept isTriangularOperand = isStoredMatrix<M> &&
+    (std::same_as<packer_t<M>,FullPackerCM> || std::same_as<packer_t<M>,FullPackerRM> ||
+     std::same_as<packer_t<M>,UpperTriangularPackerCM> || std::same_as<packer_t<M>,UpperTriangularPackerRM> ||
+     std::same_as<packer_t<M>,LowerTriangularPackerCM> || std::same_as<packer_t<M>,LowerTriangularPackerRM>) &&
+    (std::same_as<shaper_t<M>,FullShaper> || std::same_as<shaper_t<M>,UpperTriangularShaper> || std::same_as<shaper_t<M>,LowerTriangularShaper>);
+
+template <class Ma, class Mb> concept isTriangularProduct = isTriangularOperand<Ma> && isTriangularOperand<Mb> &&
+    std::same_as<typename Ma::value_type,typename Mb::value_type> &&
+    (triangular_shape<shaper_t<Ma>>!=native::shape::full || triangular_shape<shaper_t<Mb>>!=native::shape::full) &&
+    requires {typename MatrixProductPackerType<packer_t<Ma>,packer_t<Mb>>::packer_t;};
+
+// The symmetry of a stored matrix, rebound to read its storage through a span.
+template <class T, isPacker P, isShaper S, class D, template <class,isPacker> class Sym>
+Sym<std::span<const T>,P> span_symmetry(const Matrix<T,P,S,D,Sym<D,P>>&);
+template <class M> using span_symmetry_t=decltype(span_symmetry(std::declval<const M&>()));
+
+// Column major copy of stored data with explicit zeros outside the shape.  Only the shape is read, through the
+// symmetry Sy so the mirrored half of symmetric storage comes out too.
+template <class Sy, class T, isPacker P, isShaper S> default_data_type<T> expand_stored(const T* data, const P& p, const S& s)
+{
+    default_data_type<T> d(p.nr()*p.nc()); //Value initialized, i.e. zeros.
+    std::span<const T> sp(data,data ? p.stored_size() : 0);
+    Sy sym(sp,p);
+    for (size_t j=0;j<p.nc();j++)
+        for (size_t i:s.nonzero_row_indexes(j))
+            d[i+j*p.nr()]=sym.apply(i,j);
+    return d;
+}
+
+template <class Ma, class Mb, std::ranges::viewable_range R, std::ranges::viewable_range C, isPacker P, isShaper S>
+class TriangularMatrixProductView
+: MatrixProductView<R,C,P,S>
+{
+public:
+    using Base=MatrixProductView<R,C,P,S>;
+    using value_type=Base::value_type;
+    using Base::operator();
+    using Base::nr;
+    using Base::nc;
+    using Base::rows;
+    using Base::cols;
+    using Base::packer;
+    using Base::shaper;
+    using Base::set_operands;
+    using Base::reads;
+
+    TriangularMatrixProductView(const Ma& a, const Mb& b, const R& rows, const C& cols, P packer, S shaper)
+    : Base(rows,cols,packer,shaper), a_data(data(a)), b_data(data(b)), pa(a.packer()), pb(b.packer()), sha(a.shaper()), shb(b.shaper()) {}
+    // Called from Matrix::load.  Full storage destinations are written in place, packed ones through a buffer.
+    template <isPacker Pc, isShaper Sc, class D> void assign_to(Matrix<value_type,Pc,Sc,D,NoSymmetry<D,Pc>>& c) const
+    {
+        assert(c.nr()==nr() && c.nc()==nc());
+        size_t m=nr(), n=nc(), k=pa.nc();
+        if (m==0 || n==0) return;
+        default_data_type<value_type> ad,bd; //Expanded operands, if needed.
+        auto A=operand<span_symmetry_t<Ma>>(a_data,pa,sha,ad);
+        auto B=operand<span_symmetry_t<Mb>>(b_data,pb,shb,bd);
+        constexpr native::shape sa=triangular_shape<shaper_t<Ma>>, sb=triangular_shape<shaper_t<Mb>>;
+        if constexpr (std::same_as<Pc,FullPackerCM> || std::same_as<Pc,FullPackerRM>)
+        {
+            Pc pc=c.packer();
+            native::triangular_gemm(m,n,k,value_type(1),sa,A.data,A.rs,A.cs,sb,B.data,B.rs,B.cs,value_type(0),&*c.begin(),pc.row_stride(),pc.col_stride());
+        }
+        else
+        {
+            default_data_type<value_type> cd(m*n);
+            native::triangular_gemm(m,n,k,value_type(1),sa,A.data,A.rs,A.cs,sb,B.data,B.rs,B.cs,value_type(0),&cd[0],1,m);
+            Pc pc=c.packer();
+            for (size_t j=0;j<n;j++)
+                for (size_t i:c.shaper().nonzero_row_indexes(j))
+                    if (pc.is_stored(i,j)) c(i,j)=cd[i+j*m];
+        }
+    }
+    // A block of a full matrix, from SubMatrixView::load.
+    void assign_to(strided_data<value_type> c, value_type alpha, value_type beta) const
+    {
+        size_t m=nr(), n=nc(), k=pa.nc();
+        if (m==0 || n==0) return;
+        default_data_type<value_type> ad,bd;
+        auto A=operand<span_symmetry_t<Ma>>(a_data,pa,sha,ad);
+        auto B=operand<span_symmetry_t<Mb>>(b_data,pb,shb,bd);
+        constexpr native::shape sa=triangular_shape<shaper_t<Ma>>, sb=triangular_shape<shaper_t<Mb>>;
+        native::triangular_gemm(m,n,k,alpha,sa,A.data,A.rs,A.cs,sb,B.data,B.rs,B.cs,beta,c.data,c.rs,c.cs);
+    }
+
+private:
+    template <class M> static const value_type* data(const M& m) {return m.size()>0 ? &*m.begin() : nullptr;}
+    // Full storage of a full shape in place, anything else expanded into buf.
+    template <class Sy, isPacker Pk, isShaper Sh> static strided_data<const value_type> operand(const value_type* d, const Pk& p, const Sh& s, default_data_type<value_type>& buf)
+    {
+        if constexpr ((std::same_as<Pk,FullPackerCM> || std::same_as<Pk,FullPackerRM>) && std::same_as<Sh,FullShaper>)
+            return {d,p.row_stride(),p.col_stride()};
+        else
+        {
+            buf=expand_stored<Sy>(d,p,s);
+            return {buf.size()>0 ? &buf[0] : nullptr,1,p.nr()};
+        }
+    }
+    // Same lifetime rules as the other product views, the operands' storage must outlive the view.
+    const value_type* a_data;
+    const value_type* b_data;
+    packer_t<Ma> pa;
+    packer_t<Mb> pb;
+    shaper_t<Ma> sha;
+    shaper_t<Mb> shb;
+};
+
+// Views whose elements are dot products.  As operands of another product they get a MatrixCacheView.
+template <class R, class C, isPacker P, isShaper S> constexpr bool costly_elements<MatrixProductView<R,C,P,S>> =true;
+template <class R, class C> constexpr bool costly_elements<FullMatrixCMProductView<R,C>> =true;
+template <class R, class C> constexpr bool costly_elements<FullTransposeProductView<R,C>> =true;
+template <class R, class C, isPacker P, bool Left> constexpr bool costly_elements<SymmetricFullProductView<R,C,P,Left>> =true;
+template <class Ma, class Mb, class R, class C, isPacker P, isShaper S> constexpr bool costly_elements<TriangularMatrixProductView<Ma,Mb,R,C,P,S>> =true;
+template <class V, class Ma, class Mb> constexpr bool costly_elements<FactoredView<V,Ma,Mb>> =costly_elements<V>;
+
+// general overloaded op* for matricies.  Costly operands, i.e. (A*B+C)*D, are cached first so each of
+// their rows and columns is evaluated once.
 auto operator*(const isMatrix auto& a,const isMatrix auto& b)
 {
     assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
-    auto p=MatrixProductPacker(a.packer(),b.packer());
-    auto s=MatrixProductShaper(a.shaper(),b.shaper());
-    return MatrixProductView(a.rows(),b.cols(),p,s);
+    using Ma=std::remove_cvref_t<decltype(a)>;
+    using Mb=std::remove_cvref_t<decltype(b)>;
+    if constexpr (costly_elements<Ma> || costly_elements<Mb>)
+        return cached_if_costly(a)*cached_if_costly(b);
+    else
+    {
+        auto p=MatrixProductPacker(a.packer(),b.packer());
+        auto s=MatrixProductShaper(a.shaper(),b.shaper());
+        if constexpr (isChainLeaf<Ma> && isChainLeaf<Mb>)
+            return factored(reading(MatrixProductView(a.rows(),b.cols(),p,s),a,b),a,b);
+        else
+            return reading(MatrixProductView(a.rows(),b.cols(),p,s),a,b);
+    }
 }
 
 // Special version for full matrix products.
@@ -203,7 +812,167 @@ template <class T> auto operator*(const FullMatrixCM<T>& a,const FullMatrixCM<T>
     assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
     auto p=MatrixProductPacker(a.packer(),b.packer());
     auto s=MatrixProductShaper(a.shaper(),b.shaper());
-    return FullMatrixCMProductView(a.rows(),b.cols(),p,s); //Cache friendly version
+    const T* a_data= a.size()>0 ? &*a.begin() : nullptr;
+    const T* b_data= b.size()>0 ? &*b.begin() : nullptr;
+    return factored(reading(FullMatrixCMProductView(a.rows(),b.cols(),p,s,a_data,a.packer().ld(),b_data,b.packer().ld(),a.nc()),a,b),a,b); //Cache friendly version
+}
+
+// Fixed size products are cheap enough to evaluate right away, fully unrolled.
+template <class T, size_t M, size_t K, size_t N> FixedMatrixCM<T,M,N> operator*(const FixedMatrixCM<T,M,K>& a,const FixedMatrixCM<T,K,N>& b)
+{
+    FixedMatrixCM<T,M,N> c;
+    native::fixed_gemm<M,K,N>(&*a.begin(),&*b.begin(),&*c.begin());
+    return c;
+}
+
+// Diagonal products.  These skip the row/col intersections entirely.
+template <class T> auto operator*(const DiagonalMatrix<T>& a,const DiagonalMatrix<T>& b)
+{
+    assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
+    auto p=MatrixProductPacker(a.packer(),b.packer());
+    auto s=MatrixProductShaper(a.shaper(),b.shaper());
+    const T* a_data= a.size()>0 ? &*a.begin() : nullptr;
+    const T* b_data= b.size()>0 ? &*b.begin() : nullptr;
+    return factored(reading(DiagonalMatrixProductView(a.rows(),b.cols(),p,s,a_data,b_data,std::min(a.size(),b.size())),a,b),a,b);
+}
+// Diagonal times full, from either side, is a row or column scaling of the full matrix.
+template <bool Left, class T, isPacker P> auto DiagonalScaledProduct(const Matrix<T,DiagonalPacker,DiagonalShaper>& d, const Matrix<T,P,FullShaper>& f)
+{
+    const T* d_data= d.size()>0 ? &*d.begin() : nullptr;
+    const T* f_data= f.size()>0 ? &*f.begin() : nullptr;
+    P pf=f.packer();
+    if constexpr (Left)
+    {
+        assert(d.nc() == f.nr() && "Matrix dimensions do not match for multiplication");
+        auto rows=d.rows();
+        auto cols=f.cols();
+        return reading(DiagonalScaledMatrixView<decltype(rows),decltype(cols),P,Left>(rows,cols,MatrixProductPacker(d.packer(),pf),
+            MatrixProductShaper(d.shaper(),f.shaper()),d_data,d.size(),f_data,pf.row_stride(),pf.col_stride()),d,f);
+    }
+    else
+    {
+        assert(f.nc() == d.nr() && "Matrix dimensions do not match for multiplication");
+        auto rows=f.rows();
+        auto cols=d.cols();
+        return reading(DiagonalScaledMatrixView<decltype(rows),decltype(cols),P,Left>(rows,cols,MatrixProductPacker(pf,d.packer()),
+            MatrixProductShaper(f.shaper(),d.shaper()),d_data,d.size(),f_data,pf.row_stride(),pf.col_stride()),d,f);
+    }
+}
+// Exact types so these win over the general op* above.
+template <class T> auto operator*(const DiagonalMatrix<T>& a,const FullMatrixCM<T>& b) {return factored(DiagonalScaledProduct<true >(a,b),a,b);}
+template <class T> auto operator*(const DiagonalMatrix<T>& a,const FullMatrixRM<T>& b) {return factored(DiagonalScaledProduct<true >(a,b),a,b);}
+template <class T> auto operator*(const FullMatrixCM<T>& a,const DiagonalMatrix<T>& b) {return factored(DiagonalScaledProduct<false>(b,a),a,b);}
+template <class T> auto operator*(const FullMatrixRM<T>& a,const DiagonalMatrix<T>& b) {return factored(DiagonalScaledProduct<false>(b,a),a,b);}
+
+// Band products walk the band diagonals directly.
+template <class T> auto operator*(const SBandMatrix<T>& a,const SBandMatrix<T>& b)
+{
+    assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
+    auto p=MatrixProductPacker(a.packer(),b.packer());
+    auto s=MatrixProductShaper(a.shaper(),b.shaper());
+    const T* a_data= a.size()>0 ? &*a.begin() : nullptr;
+    const T* b_data= b.size()>0 ? &*b.begin() : nullptr;
+    return factored(reading(SBandMatrixProductView(a.rows(),b.cols(),p,s,a_data,a.bandwidth(),b_data,b.bandwidth()),a,b),a,b);
+}
+template <bool Left, class T, isPacker P> auto SBandFullProduct(const SBandMatrix<T>& sb, const Matrix<T,P,FullShaper>& f)
+{
+    const T* s_data= sb.size()>0 ? &*sb.begin() : nullptr;
+    const T* f_data= f.size()>0 ? &*f.begin() : nullptr;
+    P pf=f.packer();
+    if constexpr (Left)
+    {
+        assert(sb.nc() == f.nr() && "Matrix dimensions do not match for multiplication");
+        auto rows=sb.rows();
+        auto cols=f.cols();
+        return reading(SBandFullProductView<decltype(rows),decltype(cols),P,Left>(rows,cols,MatrixProductPacker(sb.packer(),pf),
+            MatrixProductShaper(sb.shaper(),f.shaper()),s_data,sb.bandwidth(),f_data,pf.row_stride(),pf.col_stride()),sb,f);
+    }
+    else
+    {
+        assert(f.nc() == sb.nr() && "Matrix dimensions do not match for multiplication");
+        auto rows=f.rows();
+        auto cols=sb.cols();
+        return reading(SBandFullProductView<decltype(rows),decltype(cols),P,Left>(rows,cols,MatrixProductPacker(pf,sb.packer()),
+            MatrixProductShaper(f.shaper(),sb.shaper()),s_data,sb.bandwidth(),f_data,pf.row_stride(),pf.col_stride()),sb,f);
+    }
+}
+template <class T> auto operator*(const SBandMatrix<T>& a,const FullMatrixCM<T>& b) {return factored(SBandFullProduct<true >(a,b),a,b);}
+template <class T> auto operator*(const SBandMatrix<T>& a,const FullMatrixRM<T>& b) {return factored(SBandFullProduct<true >(a,b),a,b);}
+template <class T> auto operator*(const FullMatrixCM<T>& a,const SBandMatrix<T>& b) {return factored(SBandFullProduct<false>(b,a),a,b);}
+template <class T> auto operator*(const FullMatrixRM<T>& a,const SBandMatrix<T>& b) {return factored(SBandFullProduct<false>(b,a),a,b);}
+
+// Symmetric times full, from either side.
+template <bool Left, class T, isPacker P> auto SymmetricFullProduct(const SymmetricMatrixCM<T>& sy, const Matrix<T,P,FullShaper>& f)
+{
+    const T* s_data= sy.size()>0 ? &*sy.begin() : nullptr;
+    const T* f_data= f.size()>0 ? &*f.begin() : nullptr;
+    P pf=f.packer();
+    if constexpr (Left)
+    {
+        assert(sy.nc() == f.nr() && "Matrix dimensions do not match for multiplication");
+        auto rows=sy.rows();
+        auto cols=f.cols();
+        return reading(SymmetricFullProductView<decltype(rows),decltype(cols),P,Left>(rows,cols,MatrixProductPacker(sy.packer(),pf),
+            MatrixProductShaper(sy.shaper(),f.shaper()),s_data,sy.nr(),f_data,pf.row_stride(),pf.col_stride()),sy,f);
+    }
+    else
+    {
+        assert(f.nc() == sy.nr() && "Matrix dimensions do not match for multiplication");
+        auto rows=f.rows();
+        auto cols=sy.cols();
+        return reading(SymmetricFullProductView<decltype(rows),decltype(cols),P,Left>(rows,cols,MatrixProductPacker(pf,sy.packer()),
+            MatrixProductShaper(f.shaper(),sy.shaper()),s_data,sy.nr(),f_data,pf.row_stride(),pf.col_stride()),sy,f);
+    }
+}
+template <class T> auto operator*(const SymmetricMatrixCM<T>& a,const FullMatrixCM<T>& b) {return SymmetricFullProduct<true >(a,b);}
+template <class T> auto operator*(const SymmetricMatrixCM<T>& a,const FullMatrixRM<T>& b) {return SymmetricFullProduct<true >(a,b);}
+template <class T> auto operator*(const FullMatrixCM<T>& a,const SymmetricMatrixCM<T>& b) {return SymmetricFullProduct<false>(b,a);}
+template <class T> auto operator*(const FullMatrixRM<T>& a,const SymmetricMatrixCM<T>& b) {return SymmetricFullProduct<false>(b,a);}
+
+// A*~B and ~A*B, see FullTransposeProductView.  Equal data is what makes the product symmetric.
+// For A*~A ~A refers to A itself, so the address says it.  Otherwise the values are compared.
+template <class T> bool same_data(const FullMatrixCM<T>& a,const FullMatrixCM<T>& b)
+{
+    if (&a==&b) return true;
+    if (a.nr()!=b.nr() || a.nc()!=b.nc()) return false;
+    if (a.packer().ld()==b.packer().ld()) return std::equal(a.begin(),a.end(),b.begin());
+    for (size_t j=0;j<a.nc();j++)
+        for (size_t i=0;i<a.nr();i++)
+            if (a(i,j)!=b(i,j)) return false;
+    return true;
+}
+template <class T> auto operator*(const FullMatrixCM<T>& a,const MatrixTransposeView<const FullMatrixCM<T>&>& b)
+{
+    assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
+    const FullMatrixCM<T>& bt=b.transposed();
+    auto p=MatrixProductPacker(a.packer(),b.packer());
+    auto s=MatrixProductShaper(a.shaper(),b.shaper());
+    const T* a_data= a.size()>0 ? &*a.begin() : nullptr;
+    bool sym=same_data(a,bt);
+    const T* b_data= sym ? a_data : bt.size()>0 ? &*bt.begin() : nullptr;
+    return reading(FullTransposeProductView(a.rows(),b.cols(),p,s,a_data,1,a.packer().ld(),b_data,(sym ? a : bt).packer().ld(),1,a.nc(),sym),a,bt);
+}
+template <class T> auto operator*(const MatrixTransposeView<const FullMatrixCM<T>&>& a,const FullMatrixCM<T>& b)
+{
+    assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
+    const FullMatrixCM<T>& at=a.transposed();
+    auto p=MatrixProductPacker(a.packer(),b.packer());
+    auto s=MatrixProductShaper(a.shaper(),b.shaper());
+    bool sym=same_data(at,b);
+    const T* b_data= b.size()>0 ? &*b.begin() : nullptr;
+    const T* a_data= sym ? b_data : at.size()>0 ? &*at.begin() : nullptr;
+    return reading(FullTransposeProductView(a.rows(),b.cols(),p,s,a_data,(sym ? b : at).packer().ld(),1,b_data,1,b.packer().ld(),b.nr(),sym),at,b);
+}
+
+// Triangular operands, see TriangularMatrixProductView.  More constrained than the general op*, so it wins.
+template <isMatrix Ma, isMatrix Mb> requires isTriangularProduct<Ma,Mb> auto operator*(const Ma& a,const Mb& b)
+{
+    assert(a.nc() == b.nr() && "Matrix dimensions do not match for multiplication");
+    auto p=MatrixProductPacker(a.packer(),b.packer());
+    auto s=MatrixProductShaper(a.shaper(),b.shaper());
+    auto rows=a.rows();
+    auto cols=b.cols();
+    return reading(TriangularMatrixProductView<Ma,Mb,decltype(rows),decltype(cols),decltype(p),decltype(s)>(a,b,rows,cols,p,s),a,b);
 }
 
 } // namespace
\ No newline at end of file
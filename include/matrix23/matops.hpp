@@ -2,26 +2,94 @@
 #pragma once
 
 #include "matrix23/matrix.hpp"
+#include "matrix23/symmm.hpp"
+#include "matrix23/fixedmm.hpp"
 
 namespace matrix23
 {
 
-auto operator*(const isMatrix auto& m, const isVector auto& v)
+// Stored matrices are held by reference, other expressions are cheap views held by value.  Copying A in
+// A+B would cost as much as the sum itself.
+template <class M> using operand_t=std::conditional_t<requires (const M& m) {m.storage();}, const M&, M>;
+// Stored vectors too, A*x copying x would allocate.
+template <class V> using vector_operand_t=std::conditional_t<requires (const V& v) {v.storage();}, const V&, V>;
+
+//
+//  A*x and x*A, a row or column of A times x per element.  Mixes all of A and x, see mixed_spans.  When A has
+//  full storage and x is stored and contiguous, assigning to a Vector skips the rows and calls native::gemv
+//  with the destination's pointer, x*A as ~A*x.
+//
+template <std::ranges::viewable_range R, class T> class MatrixVectorView : public VectorView<R>
+{
+public:
+    MatrixVectorView(R&& r, const iota_view& indices) : VectorView<R>(std::forward<R>(r),indices) {}
+    void set_gemv(size_t m, size_t n, strided_data<const T> a, const T* x) {nr=m; nc=n; A=a; itsX=x;}
+    // y=alpha*this+beta*y.  False if there is no direct path.
+    bool assign_to(T* y, T alpha, T beta) const
+    {
+        if (!A.data) return false;
+        native::gemv(nr,nc,alpha,A.data,A.rs,A.cs,itsX,beta,y);
+        return true;
+    }
+private:
+    size_t nr=0,nc=0;
+    strided_data<const T> A{nullptr,0,0};
+    const T* itsX=nullptr;
+};
+
+template <isMatrix M, isVector V> auto operator*(const M& m, const V& v)
 {
+    typedef typename std::remove_cvref_t<M>::value_type T;
     assert(m.nc()==v.size());
     auto rows=m.rows();
     auto indices=std::views::iota(size_t(0),rows.size());
-    auto mv= indices | std::views::transform([rows,v](size_t i) {return rows[i] * v;});
+    auto mv= indices | std::views::transform([rows,x=std::tuple<vector_operand_t<V>>(v)](size_t i) {return rows[i] * std::get<0>(x);});
     assert(mv.size()==rows.size());
-    return VectorView(std::move(mv), indices);
+    MatrixVectorView<decltype(mv),T> r(std::move(mv), indices);
+    r.mixing(mixed_spans().add(storage_of(m)).add(storage_of(v)));
+    if constexpr (hasStrided<M,T> && std::ranges::contiguous_range<const V> && std::same_as<std::ranges::range_value_t<V>,T>)
+        if (m.nr()>0 && m.nc()>0) r.set_gemv(m.nr(),m.nc(),strided_data<const T>(m.strided()),std::ranges::data(v));
+    return r;
 }
-auto operator*(const isVector auto& v,const isMatrix auto& m)
+template <isVector V, isMatrix M> auto operator*(const V& v, const M& m)
 {
+    typedef typename std::remove_cvref_t<M>::value_type T;
+    assert(m.nr()==v.size());
     auto cols=m.cols();
     auto indices=std::views::iota(size_t(0),cols.size());
-    auto vm=indices | std::views::transform([cols,v](size_t j) {return v * cols[j];});
+    auto vm=indices | std::views::transform([cols,x=std::tuple<vector_operand_t<V>>(v)](size_t j) {return std::get<0>(x) * cols[j];});
     assert(vm.size()==cols.size());
-    return VectorView(std::move(vm), indices);
+    MatrixVectorView<decltype(vm),T> r(std::move(vm), indices);
+    r.mixing(mixed_spans().add(storage_of(m)).add(storage_of(v)));
+    if constexpr (hasStrided<M,T> && std::ranges::contiguous_range<const V> && std::same_as<std::ranges::range_value_t<V>,T>)
+        if (m.nr()>0 && m.nc()>0)
+        {
+            strided_data<const T> a=m.strided();
+            r.set_gemv(m.nc(),m.nr(),{a.data,a.cs,a.rs},std::ranges::data(v));
+        }
+    return r;
+}
+// Symmetric*vector in one pass over the packed upper triangle.  S*v=v*S.
+template <class T> Vector<T> operator*(const SymmetricMatrixCM<T>& s, const Vector<T>& v)
+{
+    assert(s.nc()==v.size());
+    Vector<T> sv(s.nr());
+    if (s.nr()>0) native::spmv(s.nr(),&*s.begin(),&*v.begin(),&*sv.begin());
+    return sv;
+}
+template <class T> Vector<T> operator*(const Vector<T>& v, const SymmetricMatrixCM<T>& s) {return s*v;}
+// Fixed size, unrolled.
+template <class T, size_t M, size_t N> FixedVector<T,M> operator*(const FixedMatrixCM<T,M,N>& a, const FixedVector<T,N>& x)
+{
+    FixedVector<T,M> y;
+    native::fixed_gemv<M,N>(&*a.begin(),&*x.begin(),&*y.begin());
+    return y;
+}
+template <class T, size_t M, size_t N> FixedVector<T,N> operator*(const FixedVector<T,M>& x, const FixedMatrixCM<T,M,N>& a)
+{
+    FixedVector<T,N> y;
+    native::fixed_gevm<M,N>(&*a.begin(),&*x.begin(),&*y.begin());
+    return y;
 }
 
 template <isMatrix M> bool operator==(const M& a,const std::initializer_list<std::initializer_list<double>>& b)
@@ -38,6 +106,22 @@ template <isMatrix M, isMatrix Mb> bool operator==(const M& a,const Mb& b)
 }
  
 
+// Stored matrices and elementwise views over them.
+template <class M> concept isFusable = requires (const std::remove_cvref_t<M>& m) {m.stored_values();};
+// Only stored matrices, views don't know their transposed layout.
+template <class M> concept isStoredFusable = isFusable<M> && requires (const std::remove_cvref_t<M>& m) {m.storage();};
+
+// Packer and shaper of an elementwise combination.  Same types as for a product, but bands don't widen.
+template <isPacker A, isPacker B> auto MatrixSumPacker(const A& a, const B& b) {return MatrixProductPacker(a,b);}
+template <isShaper A, isShaper B> auto MatrixSumShaper(const A& a, const B& b) {return MatrixProductShaper(a,b);}
+inline auto MatrixSumPacker(const SBandPacker& a, const SBandPacker& b) {return SBandPacker(a.nr(),std::max(a.bandwidth(),b.bandwidth()));}
+inline auto MatrixSumShaper(const SBandShaper& a, const SBandShaper& b) {return SBandShaper(a.nr(),a.nc(),std::max(a.bandwidth(),b.bandwidth()));}
+
+//
+//  Elementwise views.  When every matrix under one is stored like the destination (same packer, symmetry
+//  and layout), Matrix::load_fused() evaluates the whole tree with stored_values() in a single pass over
+//  the raw data.  Otherwise elements come from operator()(i,j).
+//
 template <isMatrix M, isMatrix Mb, class Op> class MatrixBinOpView
 {
 public:
@@ -54,13 +138,23 @@ public:
     size_t nc  () const {return a.nc(); }
     auto rows  () const {return std::views::zip_transform(op,a.rows(),b.rows());}
     auto cols  () const {return std::views::zip_transform(op,a.cols(),b.cols());}
-    auto packer() const {return MatrixProductPacker(a.packer(),b.packer());}
-    auto shaper() const {return MatrixProductShaper(a.shaper(),b.shaper());}
+    auto packer() const {return MatrixSumPacker(a.packer(),b.packer());}
+    auto shaper() const {return MatrixSumShaper(a.shaper(),b.shaper());}
+    bool reads(const storage_span& s) const {return reads_from(a,s) || reads_from(b,s);}
+    template <class Mc> bool stored_like(const Mc& c) const requires isFusable<M> && isFusable<Mb>
+    {
+        return a.stored_like(c) && b.stored_like(c);
+    }
+    auto stored_values() const requires isFusable<M> && isFusable<Mb>
+    {
+        return [fa=a.stored_values(),fb=b.stored_values(),op=op](size_t k) {return op(fa(k),fb(k));};
+    }
 private:
     M a; 
     Mb b; 
     Op op; 
 };
+template <isMatrix M, isMatrix Mb, class Op> MatrixBinOpView(const M&, const Mb&, const Op&) -> MatrixBinOpView<operand_t<M>,operand_t<Mb>,Op>;
 
 template <isMatrix M, class Op> class MatrixOpView
 {
@@ -76,10 +170,17 @@ public:
     auto cols  () const {return std::views::transform(a.cols(),op);}
     auto packer() const {return a.packer();}
     auto shaper() const {return a.shaper();}
+    bool reads(const storage_span& s) const {return reads_from(a,s);}
+    template <class Mc> bool stored_like(const Mc& c) const requires isFusable<M> {return a.stored_like(c);}
+    auto stored_values() const requires isFusable<M>
+    {
+        return [fa=a.stored_values(),op=op](size_t k) {return op(fa(k));};
+    }
 private:
     M a; 
     Op op; 
 };
+template <isMatrix M, class Op> MatrixOpView(const M&, const Op&) -> MatrixOpView<operand_t<M>,Op>;
 
 
 
@@ -106,64 +207,73 @@ auto operator/(const isMatrix auto& a,const arithmetic auto& b)
 }
 
 // isMatrix cannot support these because it does not store data or have 1D linear iterators..
+// Only stored elements are touched, not the padding of full or band storage.
+template <typename T, isPacker P, isShaper S, typename D, isSymmetry Sym, class F> void for_each_stored(Matrix<T,P,S,D,Sym>& a, F&& f)
+{
+    auto d=a.begin();
+    a.packer().for_each_stored([&](size_t, size_t, size_t o) {f(d[o]);});
+}
 template <typename T, isPacker P, isShaper S, typename D, isSymmetry Sym> auto& operator+=(Matrix<T,P,S,D,Sym>& a, const arithmetic auto& b)
 {
-    for (auto& ia:a) ia+=b;
+    for_each_stored(a,[b](T& ia) {ia+=b;});
     return a;
 }
 template <typename T, isPacker P, isShaper S, typename D, isSymmetry Sym> auto& operator-=(Matrix<T,P,S,D,Sym>& a, const arithmetic auto& b)
 {
-    for (auto& ia:a) ia-=b;
+    for_each_stored(a,[b](T& ia) {ia-=b;});
     return a;
 }
 template <typename T, isPacker P, isShaper S, typename D, isSymmetry Sym> auto& operator*=(Matrix<T,P,S,D,Sym>& a, const arithmetic auto& b)
 {
-    for (auto& ia:a) ia*=b;
+    for_each_stored(a,[b](T& ia) {ia*=b;});
     return a;
 }
 template <typename T, isPacker P, isShaper S, typename D, isSymmetry Sym> auto& operator/=(Matrix<T,P,S,D,Sym>& a, const arithmetic auto& b)
 {
-    for (auto& ia:a) ia/=b;
+    for_each_stored(a,[b](T& ia) {ia/=b;});
     return a;
 }
 
 
+// Same storage, element by element.  Different padding or bandwidth goes through update().
 template <typename Ta, typename Tb,isPacker P, isShaper S, typename D, isSymmetry Sym> 
 auto& operator+=(Matrix<Ta,P,S,D,Sym>& a, const Matrix<Tb,P,S,D,Sym>& b)
 {
+    if (!same_layout(a.packer(),b.packer())) return a.update(Ta(1),b,Ta(1));
     auto ib=b.begin();
-    for (auto& ia:a) ia+=*ib++;
+    a.packer().for_each_stored([&,ia=a.begin()](size_t, size_t, size_t o) {ia[o]+=ib[o];});
     return a;
 }
 template <typename Ta, typename Tb,isPacker P, isShaper S, typename D, isSymmetry Sym> 
 auto& operator-=(Matrix<Ta,P,S,D,Sym>& a, const Matrix<Tb,P,S,D,Sym>& b)
 {
+    if (!same_layout(a.packer(),b.packer())) return a.update(Ta(-1),b,Ta(1));
     auto ib=b.begin();
-    for (auto& ia:a) ia+=*ib++;
+    a.packer().for_each_stored([&,ia=a.begin()](size_t, size_t, size_t o) {ia[o]-=ib[o];});
     return a;
 }
 
+// Expressions are accumulated in place, C+=A*B is a gemm with beta=1 when there is a native kernel.
 template <typename T,isPacker P, isShaper S, typename D, isSymmetry Sym> 
 auto& operator+=(Matrix<T,P,S,D,Sym>& a, const isMatrix auto& b)
 {
     assert(a.nr()==b.nr());
     assert(a.nc()==b.nc());
-    for (auto i:iota_view(size_t(0),a.nr()))
-        for (auto j:a.shaper().nonzero_col_indexes(i))
-            if (a.packer().is_stored(i,j)) a(i,j)+=b(i,j);
-    return a;
+    return a.update(T(1),b,T(1));
 }
 template <typename T,isPacker P, isShaper S, typename D, isSymmetry Sym> 
 auto& operator-=(Matrix<T,P,S,D,Sym>& a, const isMatrix auto& b)
 {
     assert(a.nr()==b.nr());
     assert(a.nc()==b.nc());
-    for (auto i:iota_view(size_t(0),a.nr()))
-        for (auto j:a.shaper().nonzero_col_indexes(i))
-            if (a.packer().is_stored(i,j)) a(i,j)-=b(i,j);
-    return a;
+    return a.update(T(-1),b,T(1));
 }
 
+//
+//  ~A.  A stored matrix is held by reference.  Loaded into a matrix that stores A's elements in A's own memory
+//  order (CM upper into RM lower etc.) it is a linear copy, see stored_like_transposed().  Full into full
+//  goes through the blocked transpose kernel, see strided().
+//
 template <isMatrix M> class MatrixTransposeView
 {
 public:
@@ -178,12 +288,30 @@ public:
     auto cols  () const {return m.rows();}
     auto packer() const {return m.packer().transpose();}
     auto shaper() const {return m.shaper().transpose();}
+    const M& transposed() const {return m;} //The matrix before transposing.
+    bool reads(const storage_span& s) const {return reads_from(m,s);}
+    template <class Mc> bool stored_like(const Mc& c) const requires isStoredFusable<M> {return m.stored_like_transposed(c);}
+    auto stored_values() const requires isStoredFusable<M> {return m.stored_values();}
+    auto strided() const requires requires (const std::remove_cvref_t<M>& a) {a.strided();}
+    {
+        auto s=m.strided();
+        std::swap(s.rs,s.cs);
+        return s;
+    }
 private:
     M m; 
 };
+template <isMatrix M> MatrixTransposeView(const M&) -> MatrixTransposeView<operand_t<M>>;
 
 auto Transpose(isMatrix auto& m) {return MatrixTransposeView(m);}
 auto operator~(isMatrix auto& m) {return MatrixTransposeView(m);}
+// A=~A for square full matrices, no temporary.
+template <typename T, isPacker P, typename D, isSymmetry Sym> requires std::same_as<P,FullPackerCM> || std::same_as<P,FullPackerRM>
+void transpose_in_place(Matrix<T,P,FullShaper,D,Sym>& a)
+{
+    assert(a.nr()==a.nc() && "In place transpose needs a square matrix");
+    if (a.size()>0) native::transpose_square(a.nr(),&*a.begin(),a.packer().ld());
+}
 
 template <isMatrix M> auto fnorm(const M& m)
 {
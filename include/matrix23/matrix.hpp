@@ -5,7 +5,9 @@
 #include "matrix23/shaper.hpp"
 #include "matrix23/packer.hpp"
 #include "matrix23/symmetry.hpp"
+#include "matrix23/transpose.hpp"
 #include <iostream>
+#include <span>
 
 namespace matrix23
 {
@@ -23,6 +25,20 @@ concept isMatrix = requires (M m,size_t i, size_t j, std::remove_cvref_t<M>::val
 };
 
 
+// Element (i,j) is at data[i*rs+j*cs].  How full matrices, their blocks and transposes are handed to
+// native::copy_2d and blas.  T is const for read only access.
+template <class T> struct strided_data
+{
+    T* data;
+    size_t rs,cs;
+    operator strided_data<const T>() const requires (!std::is_const_v<T>) {return {data,rs,cs};}
+};
+// m.strided() reads elements of type T.
+template <class M, class T> concept hasStrided = requires (const M& m) {{m.strided().data} -> std::convertible_to<const T*>;};
+
+template <class Mat> class NoAlias;
+template <class T, isPacker P> class SubMatrixView;
+
 //default_data_type is defined in vector.hpp.
 
 template <typename T, isPacker P, isShaper S, typename D=default_data_type<T>, isSymmetry Sym=NoSymmetry<D,P> > class Matrix
@@ -40,6 +56,9 @@ public:
     Matrix(size_t nr, size_t nc, fill_t f, T v=T(1)) : Matrix(P(nr,nc),S(nr,nc),f,v) {} //Rect matrix with fill
     Matrix(const il_t& init) : Matrix(P(nr(init),nc(init)),S(nr(init),nc(init)),init) {} //Fill from std::initial_list
     template <isMatrix M>  Matrix(const M& m) : Matrix(P(m.nr(),m.nc()),m.shaper(),m) {} //assign from an expression.
+    // itsSymmetry holds references to data and itsPacker, so they must be re-bound to the new copy.
+    Matrix(const Matrix& m) : itsPacker(m.itsPacker), itsShaper(m.itsShaper), data(m.data), itsSymmetry(data,itsPacker) {}
+    Matrix(Matrix&& m) : itsPacker(m.itsPacker), itsShaper(m.itsShaper), data(std::move(m.data)), itsSymmetry(data,itsPacker) {}
 
     // Banded matricies have extra paramater(s) k,ku,kl etc. As such they need to pass down already created
     // packers in order to handle these extra parameters.
@@ -78,17 +97,114 @@ private:
     // All of the private generic versions should lead to this root constructor.
     Matrix(P p, S s) : itsPacker(p), itsShaper(s), data(itsPacker.stored_size()), itsSymmetry(data,itsPacker) {};
 public:
-    template <isMatrix M> auto& operator=(M&& m)
+    //
+    //  Assignment evaluates m straight into the existing storage, which is only reallocated when the
+    //  stored size changes.  If m reads this matrix, i.e. C=A*C, it goes through a temporary instead.
+    //  c.noalias()=m skips that check.  itsSymmetry refers to our own members so it never changes.
+    //
+    template <isMatrix M> Matrix& operator=(const M& m)
     {
-        if (nr()!=m.nr() || nc()!=m.nc())
-        {
-            packer().resize(m.nr(),m.nc());
-            shaper().resize(m.nr(),m.nc());
-            data=D(packer().stored_size());
-        }
+        if (reads_from(m,storage()))
+            return *this=Matrix(packer_for(m),shaper_for(m),m);
+        reshape(m);
         load(m);
         return *this;
     }
+    Matrix& operator=(const Matrix& m)
+    {
+        if constexpr (requires {itsPacker.ld();})
+            if (nr()==m.nr() && nc()==m.nc() && itsPacker.ld()!=m.itsPacker.ld())
+            {
+                load(m); //Keep our padding.
+                return *this;
+            }
+        itsPacker=m.itsPacker;
+        itsShaper=m.itsShaper;
+        data=m.data; //No reallocation if the sizes match.
+        return *this;
+    }
+    Matrix& operator=(Matrix&& m)
+    {
+        if constexpr (requires {itsPacker.ld();})
+            if (nr()==m.nr() && nc()==m.nc() && itsPacker.ld()!=m.itsPacker.ld())
+            {
+                load(m); //Keep our padding, like the copy.
+                return *this;
+            }
+        itsPacker=m.itsPacker;
+        itsShaper=m.itsShaper;
+        data=std::move(m.data);
+        return *this;
+    }
+    // this=alpha*m+beta*this in place.  beta=0 never reads the old values.  C+=A*B etc. end up here.
+    template <isMatrix M> Matrix& update(T alpha, const M& m, T beta)
+    {
+        assert(nr()==m.nr() && nc()==m.nc());
+        if (reads_from(m,storage()))
+            load(Matrix(packer_for(m),shaper_for(m),m),alpha,beta);
+        else
+            load(m,alpha,beta);
+        return *this;
+    }
+    NoAlias<Matrix> noalias() {return NoAlias<Matrix>(*this);}
+
+    storage_span storage() const
+    {
+        if (data.size()==0) return {nullptr,nullptr,true};
+        const T* d=&*begin();
+        return {d,d+data.size(),true};
+    }
+    bool reads(const storage_span& s) const {return storage().overlaps(s);}
+    // Element k of data, as a function that only holds the pointer.  See load_fused().
+    template <class Tc, isPacker Pc, isShaper Sc, typename Dc, isSymmetry Symc>
+    bool stored_like(const Matrix<Tc,Pc,Sc,Dc,Symc>& c) const requires std::ranges::contiguous_range<const D>
+    {
+        if constexpr (std::same_as<Sym,Symc>) //Same packer, data and symmetry types.
+            return same_layout(itsPacker,c.packer());
+        else
+            return false;
+    }
+    auto stored_values() const requires std::ranges::contiguous_range<const D>
+    {
+        return [d=std::ranges::data(data)](size_t k) {return d[k];};
+    }
+    // Is ~this stored like c?  i.e. CM packed upper into RM packed lower.  Then ~this is also a linear copy.
+    template <class Tc, isPacker Pc, isShaper Sc, typename Dc, isSymmetry Symc>
+    bool stored_like_transposed(const Matrix<Tc,Pc,Sc,Dc,Symc>& c) const requires std::ranges::contiguous_range<const D>
+    {
+        if constexpr (requires {{itsPacker.transposed_layout()} -> std::same_as<Pc>;})
+        {
+            if constexpr (std::same_as<D,Dc> && std::same_as<Sym,NoSymmetry<D,P>> && std::same_as<Symc,NoSymmetry<Dc,Pc>>
+                       && std::same_as<decltype(itsShaper.transpose()),Sc>)
+                return same_layout(itsPacker.transposed_layout(),c.packer());
+            else
+                return false;
+        }
+        else
+            return false;
+    }
+    // Full storage as (pointer, row stride, col stride).  See load_strided().
+    static constexpr bool full_strided=std::same_as<S,FullShaper> && std::same_as<Sym,NoSymmetry<D,P>>
+                                    && std::ranges::contiguous_range<const D> && requires (const P& p) {p.ld();};
+    strided_data<const T> strided() const requires full_strided
+    {
+        return {std::ranges::data(data),itsPacker.row_stride(),itsPacker.col_stride()};
+    }
+    strided_data<T> strided() requires full_strided
+    {
+        return {std::ranges::data(data),itsPacker.row_stride(),itsPacker.col_stride()};
+    }
+    //
+    //  The block rows x cols, indexed from 0, without copying.  Writes go to this matrix.  See submatrix.hpp.
+    //
+    SubMatrixView<T,P> submatrix(iota_view rows, iota_view cols) requires full_strided
+    {
+        return SubMatrixView<T,P>(std::ranges::data(data)+block_offset(rows,cols),P(rows.size(),cols.size(),itsPacker.ld()));
+    }
+    SubMatrixView<const T,P> submatrix(iota_view rows, iota_view cols) const requires full_strided
+    {
+        return SubMatrixView<const T,P>(std::ranges::data(data)+block_offset(rows,cols),P(rows.size(),cols.size(),itsPacker.ld()));
+    }
 
 
     //
@@ -116,21 +232,37 @@ public:
     auto begin() const { return std::begin(data); }
     auto end  () const { return std::end  (data); }
     //
-    //  2D range access.
+    //  2D range access.  Rows and columns come straight out of data when the packer stores them
+    //  contiguously (span) or with a fixed stride (strided span).  Otherwise each element is looked
+    //  up with operator().
     //
     auto row(size_t i) const
     {
         assert(i < itsPacker.nr());
         auto indices=itsShaper.nonzero_col_indexes(i);
-        auto v=  indices | std::views::transform([i,this](size_t j){return operator()(i,j);});
-        return VectorView<decltype(v)>(std::move(v),indices);
+        if constexpr (direct_slices && P::contiguous_rows)
+            return VectorView(contiguous_slice(row_offset(i,indices),indices.size()),indices);
+        else if constexpr (direct_slices && requires {itsPacker.col_stride();})
+            return VectorView(strided_slice(row_offset(i,indices),indices.size(),itsPacker.col_stride()),indices);
+        else
+        {
+            auto v=  indices | std::views::transform([i,this](size_t j){return operator()(i,j);});
+            return VectorView<decltype(v)>(std::move(v),indices);
+        }
     }
     auto col(size_t j) const
     {
         assert(j < itsPacker.nc());
         auto indices=itsShaper.nonzero_row_indexes(j);
-        auto v= indices | std::views::transform([j,this](size_t i){return operator()(i,j);});
-        return VectorView<decltype(v)>(std::move(v),indices);
+        if constexpr (direct_slices && P::contiguous_cols)
+            return VectorView(contiguous_slice(col_offset(j,indices),indices.size()),indices);
+        else if constexpr (direct_slices && requires {itsPacker.row_stride();})
+            return VectorView(strided_slice(col_offset(j,indices),indices.size(),itsPacker.row_stride()),indices);
+        else
+        {
+            auto v= indices | std::views::transform([j,this](size_t i){return operator()(i,j);});
+            return VectorView<decltype(v)>(std::move(v),indices);
+        }
     }
     auto rows() const //Assumes all rows are non-zero.
     {
@@ -159,6 +291,31 @@ public:
         std::cout << std::endl << std::endl;
     }
 protected:
+    template <class Mat> friend class NoAlias;
+    // Packer and shaper for holding m.  Banded ones come from m, only m knows the bandwidth.
+    // Full ones keep their own padded leading dimension.
+    template <isMatrix M> P packer_for(const M& m) const
+    {
+        if constexpr (requires {itsPacker.ld();})
+            return nr()==m.nr() && nc()==m.nc() ? itsPacker : P(m.nr(),m.nc());
+        else if constexpr (std::same_as<decltype(m.packer()),P>)
+            return m.packer();
+        else
+            return nr()==m.nr() && nc()==m.nc() ? itsPacker : P(m.nr(),m.nc());
+    }
+    template <isMatrix M> S shaper_for(const M& m) const
+    {
+        if constexpr (std::same_as<decltype(m.shaper()),S>)
+            return m.shaper();
+        else
+            return nr()==m.nr() && nc()==m.nc() ? itsShaper : S(m.nr(),m.nc());
+    }
+    template <isMatrix M> void reshape(const M& m)
+    {
+        itsPacker=packer_for(m);
+        itsShaper=shaper_for(m);
+        if (data.size()!=itsPacker.stored_size()) data=D(itsPacker.stored_size());
+    }
     void load(std::initializer_list<std::initializer_list<T>> init)
     {
         assert(init.size() == nr() && "Initializer list size does not match subscriptor row count");
@@ -180,61 +337,183 @@ protected:
     }
     template <isMatrix M> void load(const M& m)
     {
-        for (size_t i = 0; i < nr(); ++i)
-            for (size_t j = 0; j < nc(); ++j)
-                if (itsPacker.is_stored(i, j)) 
-                    (*this)(i,j) = m(i, j);
-                else
-                    assert(m(i,j)==itsSymmetry.apply(i,j)); //Make sure data honours the symmetry.
+        if constexpr (requires {m.assign_to(*this);})
+            m.assign_to(*this); //The expression knows a faster way to fill this matrix, i.e. a native gemm.
+        else if (!load_fused(m,T(1),T(0)) && !load_strided(m))
+        {
+            itsPacker.for_each_stored([&](size_t i, size_t j, size_t o) {data[o]=m(i,j);});
+            assert(honours_symmetry(m));
+        }
+    }
+    template <isMatrix M> void load(const M& m, T alpha, T beta)
+    {
+        if constexpr (requires {m.assign_to(*this,alpha,beta);})
+            m.assign_to(*this,alpha,beta); //i.e. gemm with alpha and beta.
+        else if (!load_fused(m,alpha,beta))
+            itsPacker.for_each_stored([&](size_t i, size_t j, size_t o)
+            {
+                T& c=data[o];
+                c= beta==T(0) ? alpha*m(i,j) : alpha*m(i,j)+beta*c;
+            });
+    }
+    // Does m agree with our symmetry on the elements we don't store?  Debug builds only, it visits all nr*nc.
+    template <isMatrix M> bool honours_symmetry(const M& m) const
+    {
+        for (size_t j = 0; j < nc(); ++j)
+            for (size_t i = 0; i < nr(); ++i)
+                if (!itsPacker.is_stored(i, j) && m(i,j)!=itsSymmetry.apply(i,j)) return false;
+        return true;
+    }
+    //
+    //  Elementwise expressions whose matrices are all stored like this one, i.e. 2*A+B-C/3, are evaluated
+    //  in one linear pass over data which the compiler can vectorize.  Structural zeros are never visited.
+    //  Returns false if m can't be done that way.
+    //
+    template <isMatrix M> bool load_fused(const M& m, T alpha, T beta)
+    {
+        if constexpr (std::ranges::contiguous_range<const D> && requires {m.stored_like(*this); m.stored_values();})
+        {
+            if (!m.stored_like(*this)) return false;
+            store_linear(std::ranges::data(data),data.size(),m.stored_values(),alpha,beta);
+            return true;
+        }
+        else
+            return false;
+    }
+    //
+    //  Full into full with a different layout or padding, i.e. CM=RM, A=~B.  native::copy_2d picks column
+    //  copies or a blocked transpose, instead of striding through one side a cache line per element.
+    //
+    template <isMatrix M> bool load_strided(const M& m)
+    {
+        if constexpr (std::ranges::contiguous_range<const D> && hasStrided<M,T> && requires {itsPacker.ld();})
+        {
+            auto s=m.strided();
+            native::copy_2d(nr(),nc(),s.data,s.rs,s.cs,std::ranges::data(data),itsPacker.row_stride(),itsPacker.col_stride());
+            return true;
+        }
+        else
+            return false;
+    }
+    //
+    //  d[k]=alpha*f(k)+beta*d[k].  Blocks of 8 go through a local array: a constant trip count and stores
+    //  that can't alias the operands is what it takes for -O2 to vectorize f.
+    //
+    template <class F> static void store_linear(T* d, size_t n, F f, T alpha, T beta)
+    {
+        if (alpha==T(1) && beta==T(0))
+            store_blocked(d,n,f);
+        else if (beta==T(0))
+            store_blocked(d,n,[f,alpha](size_t k) {return alpha*f(k);});
+        else
+            store_blocked(d,n,[f,alpha,beta,d](size_t k) {return alpha*f(k)+beta*d[k];});
+    }
+    template <class F> static void store_blocked(T* d, size_t n, F f)
+    {
+        constexpr size_t L=8;
+        size_t k=0;
+        for (;k+L<=n;k+=L)
+        {
+            T t[L];
+            for (size_t l=0;l<L;l++) t[l]=f(k+l);
+            for (size_t l=0;l<L;l++) d[k+l]=t[l];
+        }
+        for (;k<n;k++) d[k]=f(k);
+    }
+    // With no symmetry every non-zero element of a row/col is stored, so slices of data can stand in for it.
+    static constexpr bool direct_slices=std::same_as<Sym,NoSymmetry<D,P>> && std::ranges::contiguous_range<const D>;
+    // Offset of the first non-zero element in row i, col j.
+    size_t row_offset(size_t i, const iota_view& js) const {return js.empty() ? 0 : itsPacker.offset(i,js.front());}
+    size_t col_offset(size_t j, const iota_view& is) const {return is.empty() ? 0 : itsPacker.offset(is.front(),j);}
+    // n elements of data starting at offset o.
+    auto contiguous_slice(size_t o, size_t n) const
+    {
+        return std::span<const T>(std::ranges::data(data)+o,n);
     }
-    void fillvalue(T v) {for (auto& i:data) i=v;}
+    // n elements of data starting at offset o, s apart.
+    auto strided_slice(size_t o, size_t n, size_t s) const
+    {
+        return contiguous_slice(o, n==0 ? 0 : (n-1)*s+1) | std::views::stride(std::max(s,size_t(1)));
+    }
+    // Offset of the first element of a block, checked against the extents.
+    size_t block_offset(iota_view rows, iota_view cols) const
+    {
+        assert(rows.empty() || rows.back()<nr());
+        assert(cols.empty() || cols.back()<nc());
+        return rows.empty() || cols.empty() ? 0 : itsPacker.offset(rows.front(),cols.front());
+    }
+    // Stored elements only, padding and clipped band corners stay zero.
+    void fillvalue(T v) {itsPacker.for_each_stored([&](size_t, size_t, size_t o) {data[o]=v;});}
     void fillrandom(T v) 
     {
-        if (v==1)
-            for (auto& i:data) i=OMLRandPos<T>();
+        if (v==T(1))
+            itsPacker.for_each_stored([&](size_t, size_t, size_t o) {data[o]=OMLRandPos<T>();});
         else
-            for (auto& i:data) i=OMLRandPos<T>()*v;
+            itsPacker.for_each_stored([&](size_t, size_t, size_t o) {data[o]=OMLRandPos<T>()*v;});
     }
     void filldiagonal(T v) 
     {
         for (size_t i=0;i<nr()&&i<nc();i++)
             (*this)(i,i)=v;
     }
-    P itsPacker;
-    S itsShaper;
+    [[no_unique_address]] P itsPacker; //Fixed size packers and shapers are empty.
+    [[no_unique_address]] S itsShaper;
     D data;
     Sym itsSymmetry;
 };
 
 
 
+//
+//  c.noalias()=A*B, c.noalias()+=A*B.  The caller promises the right hand side doesn't read c,
+//  so it is evaluated straight into c without the storage check.
+//
+template <class Mat> class NoAlias
+{
+public:
+    explicit NoAlias(Mat& _c) : c(_c) {}
+    template <isMatrix M> Mat& operator= (const M& m) {c.reshape(m); c.load(m); return c;}
+    template <isMatrix M> Mat& operator+=(const M& m) {assert(c.nr()==m.nr() && c.nc()==m.nc()); c.load(m,Val(1),Val(1)); return c;}
+    template <isMatrix M> Mat& operator-=(const M& m) {assert(c.nr()==m.nr() && c.nc()==m.nc()); c.load(m,Val(-1),Val(1)); return c;}
+private:
+    typedef typename Mat::value_type Val;
+    Mat& c;
+};
+
 template <class T> struct FullMatrixRM : public Matrix<T,FullPackerRM,FullShaper>
 {
     using Matrix<T,FullPackerRM,FullShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,FullPackerRM,FullShaper>::operator=; //Otherwise hidden by the implicit copy assignment.
 };
 template <class T> struct FullMatrixCM : public Matrix<T,FullPackerCM,FullShaper>
 {
     using Matrix<T,FullPackerCM,FullShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,FullPackerCM,FullShaper>::operator=;
 };
 template <class T> struct UpperTriangularMatrixCM : public Matrix<T,UpperTriangularPackerCM,UpperTriangularShaper>
 {
     using Matrix<T,UpperTriangularPackerCM,UpperTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,UpperTriangularPackerCM,UpperTriangularShaper>::operator=;
 };
 template <class T> struct UpperTriangularMatrixRM : public Matrix<T,UpperTriangularPackerRM,UpperTriangularShaper>
 {
     using Matrix<T,UpperTriangularPackerRM,UpperTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,UpperTriangularPackerRM,UpperTriangularShaper>::operator=;
 };
 template <class T> struct LowerTriangularMatrixCM : public Matrix<T,LowerTriangularPackerCM,LowerTriangularShaper>
 {
     using Matrix<T,LowerTriangularPackerCM,LowerTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,LowerTriangularPackerCM,LowerTriangularShaper>::operator=;
 };
 template <class T> struct LowerTriangularMatrixRM : public Matrix<T,LowerTriangularPackerRM,LowerTriangularShaper>
 {
     using Matrix<T,LowerTriangularPackerRM,LowerTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,LowerTriangularPackerRM,LowerTriangularShaper>::operator=;
 };
 template <class T> struct DiagonalMatrix : public Matrix<T,DiagonalPacker,DiagonalShaper>
 {
     using Matrix<T,DiagonalPacker,DiagonalShaper>::Matrix;  //Inherit base constructors.
+    using Matrix<T,DiagonalPacker,DiagonalShaper>::operator=;
 };
 template <class T> struct SBandMatrix : public Matrix<T,SBandPacker,SBandShaper>
 {
@@ -243,6 +522,7 @@ public:
     using il_t=Base::il_t;
     using Base::nr;
     using Base::nc;
+    using Base::operator=;
     SBandMatrix(                  ) : SBandMatrix(0,0) {}; //nr=nc=n=0, k=0
     SBandMatrix(size_t n, size_t k) : SBandMatrix(n,k,none) {};
     SBandMatrix(size_t n, size_t k, fill_t f, T v=T(1)) : Base(SBandPacker(n,k),f,v) {};
@@ -273,24 +553,67 @@ template <class T> struct SymmetricMatrixCM
                 default_data_type<T>,
                 Symmetric<default_data_type<T>,UpperTriangularPackerCM>
                 >::Matrix;  //Inherit base constructors.
+    using Matrix<T,
+                UpperTriangularPackerCM,
+                FullShaper,
+                default_data_type<T>,
+                Symmetric<default_data_type<T>,UpperTriangularPackerCM>
+                >::operator=;
+};
+// Symmetric with full packing, both triangles are stored.  For blas symv, symm and syrk.
+template <class T> struct SymmetricMatrixFCM
+: public Matrix<T,
+                FullPackerCM,
+                FullShaper,
+                default_data_type<T>,
+                Symmetric<default_data_type<T>,FullPackerCM>
+                >
+{
+    using Matrix<T,
+                FullPackerCM,
+                FullShaper,
+                default_data_type<T>,
+                Symmetric<default_data_type<T>,FullPackerCM>
+                >::Matrix;  //Inherit base constructors.
+    using Matrix<T,
+                FullPackerCM,
+                FullShaper,
+                default_data_type<T>,
+                Symmetric<default_data_type<T>,FullPackerCM>
+                >::operator=;
 };
 
 // Triangular with full packing. Wast of space, but that is what blas level 3 supports.
 template <class T> struct UpperTriangularMatrixFCM : public Matrix<T,FullPackerCM,UpperTriangularShaper>
 {
     using Matrix<T,FullPackerCM,UpperTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,FullPackerCM,UpperTriangularShaper>::operator=;
 };
 template <class T> struct UpperTriangularMatrixFRM : public Matrix<T,FullPackerRM,UpperTriangularShaper>
 {
     using Matrix<T,FullPackerRM,UpperTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,FullPackerRM,UpperTriangularShaper>::operator=;
 };
 template <class T> struct LowerTriangularMatrixFCM : public Matrix<T,FullPackerCM,LowerTriangularShaper>
 {
     using Matrix<T,FullPackerCM,LowerTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,FullPackerCM,LowerTriangularShaper>::operator=;
 };
 template <class T> struct LowerTriangularMatrixFRM : public Matrix<T,FullPackerRM,LowerTriangularShaper>
 {
     using Matrix<T,FullPackerRM,LowerTriangularShaper>::Matrix; //Inherit base constructors.
+    using Matrix<T,FullPackerRM,LowerTriangularShaper>::operator=;
+};
+
+// Compile time sized, stored in place (std::array) with no run time dimensions.  For 3x3, 4x4 ... kernels.
+template <class T, size_t NR, size_t NC=NR> struct FixedMatrixCM
+: public Matrix<T,FixedPackerCM<NR,NC>,FixedShaper<NR,NC>,fixed_data<T,NR*NC>>
+{
+    using Base=Matrix<T,FixedPackerCM<NR,NC>,FixedShaper<NR,NC>,fixed_data<T,NR*NC>>;
+    using Base::Base; //Inherit base constructors.
+    using Base::operator=;
+    FixedMatrixCM() : Base(NR,NC) {}
+    FixedMatrixCM(fill_t f, T v=T(1)) : Base(NR,NC,f,v) {}
 };
 
 
@@ -301,4 +624,6 @@ template <class T> struct LowerTriangularMatrixFRM : public Matrix<T,FullPackerR
 } //namespace matrix23
 
 #include "matrix23/matops.hpp"
-#include "matrix23/matmul.hpp"
\ No newline at end of file
+#include "matrix23/matmul.hpp"
+#include "matrix23/matchain.hpp"
+#include "matrix23/submatrix.hpp"
\ No newline at end of file
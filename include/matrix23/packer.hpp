@@ -3,6 +3,7 @@
 
 #include "matrix23/shaper.hpp"
 #include <cassert>
+#include <algorithm>
 
 //
 // Packers define how matrix elements are arranged in memory.  For most packings (except diagonal)
@@ -14,6 +15,10 @@
 // col major means the linear data is stored in this order:
 //    [  (0,0),(1,0),(2,0)...(nr-1,0), (0,1),(1,1)...(nr-1,1) .....(nr-1,nc-1) ]
 //    col major is how Fortran, Lapack and Blas store a matrix.
+// for_each_stored(f) calls f(i,j,offset) for every stored element in storage order, so fills and loads
+// touch only what is stored and walk memory sequentially.
+// transposed_layout() is the packer that puts (j,i) where this one puts (i,j), i.e. a column major matrix
+// read as its transpose is row major.  ~A can then be copied as raw data into a matrix with that packer.
 //
 namespace matrix23
 {
@@ -26,6 +31,7 @@ template <class P> concept isPacker = requires (P const p,P pnc,size_t i, size_t
     i=p.stored_size();
     p.shaper();
     p.transpose();
+    p.for_each_stored([](size_t, size_t, size_t) {}); //(i,j,offset)
 };
 
 // Common base class for all packers.
@@ -41,6 +47,10 @@ public:
         assert(i<nrows && "   Row index ot of bounds");
         assert(j<ncols && "Column index ot of bounds");
     }
+    // Are the stored elements of each column (row) adjacent in memory?  If so Matrix::col() (row())
+    // can hand out a std::span instead of indexing element by element.
+    static constexpr bool contiguous_cols=false;
+    static constexpr bool contiguous_rows=false;
 protected:
     size_t nrows,ncols;
 };
@@ -53,28 +63,66 @@ public:
     size_t stored_size() const {return nrows * ncols;} // Total number of elements
     FullShaper shaper() const {return FullShaper(nr(),nc());}
 };
+//
+//  Full packers can have a leading dimension ld larger than the column (row) length, the extra
+//  elements pad each column (row) out to a cache line multiple.  See padded_ld() in aligned.hpp.
+//
+class FullPackerRM;
 class FullPackerCM         : public FullPacker
 {
 public:
-    using FullPacker::FullPacker; // Inherit constructors
+    FullPackerCM(size_t nr, size_t nc) : FullPacker(nr,nc), ldim(nr) {}
+    FullPackerCM(size_t nr, size_t nc, size_t ld) : FullPacker(nr,nc), ldim(ld) {assert(ld>=nr);}
+    void resize(size_t nr, size_t nc) {PackerCommon::resize(nr,nc);ldim=nr;}
+    static constexpr bool contiguous_cols=true;
+    size_t stored_size() const {return ldim * ncols;} // Includes the padding.
     size_t offset(size_t i, size_t j) const
     {
         range_check(i,j);
-        return i + j*nrows;
+        return i + j*ldim;
     }
+    // Memory distance between (i,j) -> (i+1,j) and (i,j) -> (i,j+1).  Used for passing raw data to kernels.
+    size_t row_stride() const {return 1;}
+    size_t col_stride() const {return ldim;}
+    size_t ld() const {return ldim;}
     auto transpose() const {return FullPackerCM(nc(),nr());}
+    FullPackerRM transposed_layout() const;
+    template <class F> void for_each_stored(F&& f) const
+    {
+        for (size_t j=0;j<ncols;j++)
+            for (size_t i=0;i<nrows;i++) f(i,j,i+j*ldim);
+    }
+private:
+    size_t ldim;
 };
 class FullPackerRM         : public FullPacker
 {
 public:
-    using FullPacker::FullPacker; // Inherit constructors
+    FullPackerRM(size_t nr, size_t nc) : FullPacker(nr,nc), ldim(nc) {}
+    FullPackerRM(size_t nr, size_t nc, size_t ld) : FullPacker(nr,nc), ldim(ld) {assert(ld>=nc);}
+    void resize(size_t nr, size_t nc) {PackerCommon::resize(nr,nc);ldim=nc;}
+    static constexpr bool contiguous_rows=true;
+    size_t stored_size() const {return ldim * nrows;} // Includes the padding.
     size_t offset(size_t i, size_t j) const
     {
         range_check(i,j);
-        return j + i*ncols;
+        return j + i*ldim;
     }
+    // Memory distance between (i,j) -> (i+1,j) and (i,j) -> (i,j+1).  Used for passing raw data to kernels.
+    size_t row_stride() const {return ldim;}
+    size_t col_stride() const {return 1;}
+    size_t ld() const {return ldim;}
     auto transpose() const {return FullPackerRM(nc(),nr());}
+    FullPackerCM transposed_layout() const {return FullPackerCM(nc(),nr(),ldim);}
+    template <class F> void for_each_stored(F&& f) const
+    {
+        for (size_t i=0;i<nrows;i++)
+            for (size_t j=0;j<ncols;j++) f(i,j,j+i*ldim);
+    }
+private:
+    size_t ldim;
 };
+inline FullPackerRM FullPackerCM::transposed_layout() const {return FullPackerRM(nc(),nr(),ldim);}
 
 class UpperTriangularPacker : public PackerCommon
 {
@@ -92,23 +140,39 @@ class UpperTriangularPackerRM : public UpperTriangularPacker
 {
 public:
     using UpperTriangularPacker::UpperTriangularPacker; // Inherit constructors
+    static constexpr bool contiguous_rows=true;
     size_t offset(size_t i, size_t j) const
     {
         range_check(i,j);
         return j + i*(2*ncols-i-1)/2;
     }
+    template <class F> void for_each_stored(F&& f) const
+    {
+        for (size_t i=0;i<std::min(nrows,ncols);i++)
+            for (size_t j=i,o=offset(i,i);j<ncols;j++,o++) f(i,j,o);
+    }
     auto transpose() const;
+    auto transposed_layout() const;
 };
 class UpperTriangularPackerCM : public UpperTriangularPacker
 {
 public:
     using UpperTriangularPacker::UpperTriangularPacker; // Inherit constructors
+    static constexpr bool contiguous_cols=true;
     size_t offset(size_t i, size_t j) const
     {
         range_check(i,j);
+        if (j>=nrows) return i + nrows*(nrows+1)/2 + (j-nrows)*nrows; //Full columns right of the triangle.
         return i + j*(        j+1)/2;
     }
+    template <class F> void for_each_stored(F&& f) const
+    {
+        if (nrows==0) return;
+        for (size_t j=0;j<ncols;j++)
+            for (size_t i=0,o=offset(0,j);i<std::min(j+1,nrows);i++,o++) f(i,j,o);
+    }
     auto transpose() const;
+    auto transposed_layout() const;
 };
 
 class LowerTriangularPacker : public PackerCommon
@@ -127,34 +191,56 @@ class LowerTriangularPackerRM : public LowerTriangularPacker
 {
 public:
     using LowerTriangularPacker::LowerTriangularPacker; // Inherit constructors
+    static constexpr bool contiguous_rows=true;
     size_t offset(size_t i, size_t j) const
     {
         range_check(i,j);
+        if (i>=ncols) return j + ncols*(ncols+1)/2 + (i-ncols)*ncols; //Full rows below the triangle.
         return j + i*(        i+1)/2;
     }
+    template <class F> void for_each_stored(F&& f) const
+    {
+        if (ncols==0) return;
+        for (size_t i=0;i<nrows;i++)
+            for (size_t j=0,o=offset(i,0);j<std::min(i+1,ncols);j++,o++) f(i,j,o);
+    }
     auto transpose() const;
+    auto transposed_layout() const;
 };
 class LowerTriangularPackerCM : public LowerTriangularPacker
 {
 public:
     using LowerTriangularPacker::LowerTriangularPacker; // Inherit constructors
+    static constexpr bool contiguous_cols=true;
     size_t offset(size_t i, size_t j) const
     {
         range_check(i,j);
         return i + j*(2*nrows-j-1)/2;
     }
+    template <class F> void for_each_stored(F&& f) const
+    {
+        for (size_t j=0;j<std::min(nrows,ncols);j++)
+            for (size_t i=j,o=offset(j,j);i<nrows;i++,o++) f(i,j,o);
+    }
     auto transpose() const;
+    auto transposed_layout() const;
 };
 
 inline auto UpperTriangularPackerRM::transpose() const {return LowerTriangularPackerRM(nc(),nr());}
 inline auto UpperTriangularPackerCM::transpose() const {return LowerTriangularPackerCM(nc(),nr());}
 inline auto LowerTriangularPackerRM::transpose() const {return UpperTriangularPackerRM(nc(),nr());}
 inline auto LowerTriangularPackerCM::transpose() const {return UpperTriangularPackerCM(nc(),nr());}
+inline auto UpperTriangularPackerRM::transposed_layout() const {return LowerTriangularPackerCM(nc(),nr());}
+inline auto UpperTriangularPackerCM::transposed_layout() const {return LowerTriangularPackerRM(nc(),nr());}
+inline auto LowerTriangularPackerRM::transposed_layout() const {return UpperTriangularPackerCM(nc(),nr());}
+inline auto LowerTriangularPackerCM::transposed_layout() const {return UpperTriangularPackerRM(nc(),nr());}
 
 class DiagonalPacker        : public PackerCommon
 {
 public:
     using PackerCommon::PackerCommon; // Inherit constructors
+    static constexpr bool contiguous_cols=true; //At most one element.
+    static constexpr bool contiguous_rows=true;
     bool is_stored(size_t i, size_t j) const {return i == j;}
     size_t stored_size() const {return std::min(nrows,ncols);}
     size_t offset(size_t i, size_t j) const
@@ -164,6 +250,11 @@ public:
     }
     DiagonalShaper shaper() const {return DiagonalShaper(nr(),nc());}
     auto transpose() const {return DiagonalPacker(nc(),nr());}
+    auto transposed_layout() const {return DiagonalPacker(nc(),nr());}
+    template <class F> void for_each_stored(F&& f) const
+    {
+        for (size_t i=0;i<std::min(nrows,ncols);i++) f(i,i,i);
+    }
 };
 class SBandPacker           : public PackerCommon
 {
@@ -185,11 +276,72 @@ public:
         range_check(i,j);
         return k+i-j+j*(2*k+1);
     }
+    static constexpr bool contiguous_cols=true;
+    // Memory distance between (i,j) -> (i+1,j) and (i,j) -> (i,j+1).
+    size_t row_stride() const {return 1;}
+    size_t col_stride() const {return 2*k;}
     size_t bandwidth() const {return k;}
+    // Column j holds rows j-k...j+k, clipped to the matrix.  The clipped corners are skipped.
+    template <class F> void for_each_stored(F&& f) const
+    {
+        for (size_t j=0;j<ncols;j++)
+        {
+            size_t i0= j>k ? j-k : 0;
+            for (size_t i=i0,o=offset(i0,j);i<std::min(j+k+1,nrows);i++,o++) f(i,j,o);
+        }
+    }
     private:
     friend class SBandShaper;
-    const size_t k;
+    size_t k; //Not const, matrices reassigned from a product take its bandwidth.
+};
+
+//
+//  Column major full packing with compile time dimensions.  No run time size is stored and the offsets
+//  are constexpr, so small fixed matrices index like plain arrays.
+//
+template <size_t NR, size_t NC> class FixedPackerCM
+{
+public:
+    constexpr FixedPackerCM() = default;
+    constexpr FixedPackerCM(size_t nr, size_t nc) {resize(nr,nc);}
+    constexpr void resize([[maybe_unused]] size_t nr, [[maybe_unused]] size_t nc) {assert(nr==NR && nc==NC && "Fixed size matrix can't be resized");}
+    static constexpr size_t nr() {return NR;}
+    static constexpr size_t nc() {return NC;}
+    static constexpr bool contiguous_cols=true;
+    static constexpr bool contiguous_rows=false;
+    constexpr bool is_stored(size_t i, size_t j) const {range_check(i,j);return true;}
+    static constexpr size_t stored_size() {return NR*NC;}
+    constexpr size_t offset(size_t i, size_t j) const
+    {
+        range_check(i,j);
+        return i + j*NR;
+    }
+    static constexpr size_t row_stride() {return 1;}
+    static constexpr size_t col_stride() {return NR;}
+    FixedShaper<NR,NC> shaper() const {return FixedShaper<NR,NC>();}
+    auto transpose() const {return FixedPackerCM<NC,NR>();}
+    template <class F> constexpr void for_each_stored(F&& f) const
+    {
+        for (size_t j=0;j<NC;j++)
+            for (size_t i=0;i<NR;i++) f(i,j,i+j*NR);
+    }
+private:
+    constexpr void range_check([[maybe_unused]] size_t i, [[maybe_unused]] size_t j) const
+    {
+        assert(i<NR && "   Row index ot of bounds");
+        assert(j<NC && "Column index ot of bounds");
+    }
 };
 
+// Do a and b put every element at the same offset?  Then their data can be combined element by element.
+template <isPacker P> bool same_layout(const P& a, const P& b)
+{
+    if (a.nr()!=b.nr() || a.nc()!=b.nc()) return false;
+    if constexpr (requires {a.ld();})
+        if (a.ld()!=b.ld()) return false;
+    if constexpr (requires {a.bandwidth();})
+        if (a.bandwidth()!=b.bandwidth()) return false;
+    return true;
+}
 
 } // namespace
@@ -155,6 +155,10 @@ template <> inline double OMLRand<double>()
   return GlobalRandomNumberGenerator.GetNextDouble();
 }
 
+template <> inline std::complex<float> OMLRand<std::complex<float> >()
+{
+  return std::complex<float>(OMLRand<float>(),OMLRand<float>());
+}
 template <> inline std::complex<double> OMLRand<std::complex<double> >()
 {
   return std::complex<double>(OMLRand<double>(),OMLRand<double>());
@@ -164,6 +168,10 @@ template <> inline int    OMLRandPos<int>   () {return OMLRand<int> ()&0x7ffffff
 template <> inline long   OMLRandPos<long>  () {return OMLRand<long>()&0x7fffffff;}
 template <> inline float  OMLRandPos<float> () {return OMLRand<float>();}
 template <> inline double OMLRandPos<double>() {return OMLRand<double>();}
+template <> inline std::complex<float> OMLRandPos<std::complex<float> >()
+{
+  return std::complex<float>(OMLRandPos<float>(),OMLRandPos<float>());
+}
 template <> inline std::complex<double> OMLRandPos<std::complex<double> >()
 {
   return std::complex<double>(OMLRandPos<double>(),OMLRandPos<double>());
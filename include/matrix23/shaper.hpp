@@ -3,6 +3,7 @@
 
 #include <cstddef> //To get size_t
 #include <ranges>  //To get iota_view.
+#include <cassert>
 
 //
 // A matrix shape in concerned with what elements are non-zero. But a shape is unconcerned
@@ -93,6 +94,24 @@ public:
     size_t k;
 };
 
+//
+//  Full shape with the dimensions fixed at compile time.  resize can't change them, it only checks.
+//  Converts from and to the run time shapers so fixed and dynamic matrices can be loaded from each other.
+//
+template <size_t NR, size_t NC> class FixedShaper
+{
+public:
+    constexpr FixedShaper() = default;
+    constexpr FixedShaper(size_t nr, size_t nc) {resize(nr,nc);}
+    FixedShaper(const ShaperCommon& s) {resize(s.nr(),s.nc());}
+    constexpr void resize([[maybe_unused]] size_t nr, [[maybe_unused]] size_t nc) {assert(nr==NR && nc==NC && "Fixed size matrix can't be resized");}
+    static constexpr size_t nr() {return NR;}
+    static constexpr size_t nc() {return NC;}
+    iota_view nonzero_row_indexes(size_t col) const {return std::views::iota(size_t(0),NR);}
+    iota_view nonzero_col_indexes(size_t row) const {return std::views::iota(size_t(0),NC);}
+    auto transpose() const {return FixedShaper<NC,NR>();}
+    operator FullShaper() const {return FullShaper(NR,NC);} //For loading dynamic matrices.
+};
 
 }; //namespace matrix23
 
@@ -0,0 +1,39 @@
+// File: simd.hpp  Explicitly vectorized kernels for contiguous data, with run time ISA dispatch.
+#pragma once
+
+#include <cstddef>
+#include <complex>
+#include <concepts>
+
+//
+//  The ranges pipelines in vector.hpp are too opaque for the compiler to vectorize.  When both
+//  operands sit in contiguous memory we can hand raw pointers to these kernels instead.
+//  The kernels are implemented in src/simd.cpp for AVX-512, AVX2+FMA and plain C++.  The best
+//  instruction set supported by the CPU is picked on first use, independent of the -m flags the
+//  rest of the code is compiled with.
+//
+namespace matrix23::simd
+{
+enum class isa {scalar, avx2, avx512};
+
+isa  supported(); // Best ISA this CPU can run.
+isa  selected (); // ISA the kernels are currently using.
+void select(isa); // Use a lower ISA, mostly for testing and benchmarking. Clamped to supported().
+
+// sum_i a[i]*b[i]  (no complex conjugation, same as inner_product).
+float                dot(const float               * a, const float               * b, size_t n);
+double               dot(const double              * a, const double              * b, size_t n);
+std::complex<float > dot(const std::complex<float >* a, const std::complex<float >* b, size_t n);
+std::complex<double> dot(const std::complex<double>* a, const std::complex<double>* b, size_t n);
+
+// y[i] += alpha*x[i]
+void axpy(float                alpha, const float               * x, float               * y, size_t n);
+void axpy(double               alpha, const double              * x, double              * y, size_t n);
+void axpy(std::complex<float > alpha, const std::complex<float >* x, std::complex<float >* y, size_t n);
+void axpy(std::complex<double> alpha, const std::complex<double>* x, std::complex<double>* y, size_t n);
+
+// Types with a kernel.
+template <class T> concept isSimdType =
+    std::same_as<T,float> || std::same_as<T,double> || std::same_as<T,std::complex<float>> || std::same_as<T,std::complex<double>>;
+
+} //namespace matrix23::simd
@@ -0,0 +1,125 @@
+// File: submatrix.hpp  Zero copy blocks of full matrices.
+#pragma once
+
+#include "matrix23/matrix.hpp"
+
+//
+//  A.submatrix(rows,cols) views the block rows x cols of a full CM or RM matrix, indexed from 0.  It is the
+//  parent's data pointer moved to the block plus a full packer with the parent's leading dimension, so
+//  nothing is copied and reads and writes go straight to A:
+//      auto S=A.submatrix(iota_view(3,7),iota_view(1,10));   //4 x 9
+//      S=B*C;  S+=D;  FullMatrixCM<double> E=S;
+//      gemm(1.0,A.submatrix(r,k),B.submatrix(k,c),0.0,C.submatrix(r,c)); //blas on (pointer, ld), see blas.hpp
+//  Assigning to a view writes its elements, it never rebinds.  A view of a const matrix has T const and
+//  can't be written.  Views don't own anything, they must not outlive the matrix.
+//
+namespace matrix23
+{
+
+template <class T, isPacker P> class SubMatrixView
+{
+public:
+    typedef std::remove_const_t<T> value_type;
+    SubMatrixView(T* _d, P _p) : d(_d), p(_p) {}
+    SubMatrixView(const SubMatrixView&) = default;
+
+    SubMatrixView& operator=(const SubMatrixView& m) requires (!std::is_const_v<T>) {return load(m,value_type(1),value_type(0));}
+    template <isMatrix M> SubMatrixView& operator= (const M& m) requires (!std::is_const_v<T>) {return load(m,value_type( 1),value_type(0));}
+    template <isMatrix M> SubMatrixView& operator+=(const M& m) requires (!std::is_const_v<T>) {return load(m,value_type( 1),value_type(1));}
+    template <isMatrix M> SubMatrixView& operator-=(const M& m) requires (!std::is_const_v<T>) {return load(m,value_type(-1),value_type(1));}
+
+    value_type operator()(size_t i, size_t j) const {return d[p.offset(i,j)];}
+    T&         operator()(size_t i, size_t j)       {return d[p.offset(i,j)];}
+    size_t nr  () const {return p.nr();}
+    size_t nc  () const {return p.nc();}
+    size_t size() const {return nr()*nc();}
+
+    auto row(size_t i) const
+    {
+        assert(i<nr());
+        auto indices=std::views::iota(size_t(0),nc());
+        if constexpr (P::contiguous_rows)
+            return VectorView(slice(nc()==0 ? 0 : p.offset(i,0),nc()),indices);
+        else
+            return VectorView(strided_slice(nc()==0 ? 0 : p.offset(i,0),nc(),p.col_stride()),indices);
+    }
+    auto col(size_t j) const
+    {
+        assert(j<nc());
+        auto indices=std::views::iota(size_t(0),nr());
+        if constexpr (P::contiguous_cols)
+            return VectorView(slice(nr()==0 ? 0 : p.offset(0,j),nr()),indices);
+        else
+            return VectorView(strided_slice(nr()==0 ? 0 : p.offset(0,j),nr(),p.row_stride()),indices);
+    }
+    auto rows() const {return std::views::iota(size_t(0),nr()) | std::views::transform([*this](size_t i){return row(i);});}
+    auto cols() const {return std::views::iota(size_t(0),nc()) | std::views::transform([*this](size_t j){return col(j);});}
+    P packer() const {return p;}
+    FullShaper shaper() const {return FullShaper(nr(),nc());}
+
+    // Memory from the first to the last element, gaps included.  Blocks side by side in a column major
+    // matrix interleave, so they look like they overlap.
+    bool reads(const storage_span& s) const {return footprint().overlaps(s);}
+    strided_data<T> strided() const {return {d,p.row_stride(),p.col_stride()};}
+    // A block of this block, indexed from 0.
+    SubMatrixView submatrix(iota_view rows, iota_view cols) const
+    {
+        assert(rows.empty() || rows.back()<nr());
+        assert(cols.empty() || cols.back()<nc());
+        size_t o= rows.empty() || cols.empty() ? 0 : p.offset(rows.front(),cols.front());
+        return SubMatrixView(d+o,P(rows.size(),cols.size(),p.ld()));
+    }
+private:
+    //
+    //  this=alpha*m+beta*this.  Full matrices and views come in through native::copy_2d.  Products that can
+    //  write (pointer, strides) are handed the block directly, with alpha and beta.  Other expressions with a
+    //  faster way to fill a matrix, and expressions that read this block, are evaluated into a temporary first.
+    //
+    template <isMatrix M> SubMatrixView& load(const M& m, value_type alpha, value_type beta)
+    {
+        assert(nr()==m.nr() && nc()==m.nc());
+        if (reads_from(m,footprint())) return load(evaluated(m),alpha,beta);
+        if constexpr (requires (strided_data<value_type> c) {m.assign_to(c,alpha,beta);})
+        {
+            m.assign_to(strided(),alpha,beta);
+            return *this;
+        }
+        else if constexpr (requires (FullMatrixCM<value_type>& c) {m.assign_to(c);})
+            return load(evaluated(m),alpha,beta);
+        else
+        {
+            if constexpr (hasStrided<M,value_type>)
+                if (alpha==value_type(1) && beta==value_type(0))
+                {
+                    auto s=m.strided();
+                    native::copy_2d(nr(),nc(),s.data,s.rs,s.cs,d,p.row_stride(),p.col_stride());
+                    return *this;
+                }
+            p.for_each_stored([&](size_t i, size_t j, size_t o)
+            {
+                d[o]= beta==value_type(0) ? alpha*m(i,j) : alpha*m(i,j)+beta*d[o];
+            });
+            return *this;
+        }
+    }
+    template <isMatrix M> static FullMatrixCM<value_type> evaluated(const M& m)
+    {
+        FullMatrixCM<value_type> t(m.nr(),m.nc());
+        t.noalias()=m;
+        return t;
+    }
+    storage_span footprint() const
+    {
+        if (size()==0) return {nullptr,nullptr,true};
+        return {d,d+p.offset(nr()-1,nc()-1)+1,true};
+    }
+    auto slice(size_t o, size_t n) const {return std::span<const value_type>(d+o,n);}
+    auto strided_slice(size_t o, size_t n, size_t s) const
+    {
+        return slice(o, n==0 ? 0 : (n-1)*s+1) | std::views::stride(std::max(s,size_t(1)));
+    }
+    T* d; //Element (0,0).
+    P p;  //Full packer with the parent's ld.
+};
+
+} //namespace matrix23
@@ -0,0 +1,151 @@
+// File: symmm.hpp  Native kernels for products with symmetric matrices.
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <valarray>
+#include "matrix23/gemm.hpp"
+
+//
+//  SymmetricMatrixCM keeps only the upper triangle, packed column by column like blas 'U' packing:
+//      element (i,j), i<=j, is at S[i+j*(j+1)/2]
+//  so each stored column is contiguous.  spmv walks the packed data once and applies each S(i,j) as
+//  both S(i,j) and S(j,i), instead of looking up n^2 elements through Symmetric::apply.  symm does the
+//  same for S*B, a tile of the triangle at a time.
+//  syrk builds C=A*A^T by only multiplying the column blocks of the upper triangle, about half
+//  the work of a full gemm, and then mirrors or packs the result.
+//
+namespace matrix23::native
+{
+
+//
+//  y=S*x for an n x n symmetric S in packed upper storage.
+//
+template <class T> void spmv(size_t n, const T* S, const T* x, T* y)
+{
+    std::fill(y,y+n,T(0));
+    for (size_t j=0;j<n;j++)
+    {
+        const T* sj=S+j*(j+1)/2; //sj[i] is S(i,j)=S(j,i) for i<=j
+        T xj=x[j], yj(0);
+        for (size_t i=0;i<j;i++)
+        {
+            y[i]+=sj[i]*xj;
+            yj  +=sj[i]*x[i];
+        }
+        y[j]+=yj+sj[j]*xj;
+    }
+}
+
+// Tile of S expanded for one pair of gemm calls in symm.
+inline constexpr size_t symm_tile=256;
+
+//
+//  C=alpha*S*B+beta*C for an n x n symmetric S in packed upper storage, B and C n x m as (pointer,
+//  row stride, col stride).  B*S is the same call with B and C transposed, C^T=S*B^T.  The upper
+//  triangle is walked in tiles, each copied once to a column major buffer, and each tile goes to
+//  gemm twice: as S(I,J) for rows I of C and, above the diagonal, as S(I,J)^T=S(J,I) for rows J.
+//  So every stored element is read once and applied to both (i,j) and (j,i), at gemm speed.
+//  Large products are split into column panels of B and C for the thread pool.
+//
+template <class T> void symm(size_t n, size_t m, T alpha, const T* S, const T* B, size_t rsb, size_t csb,
+    T beta, T* C, size_t rsc, size_t csc)
+{
+    if (n==0 || m==0) return;
+    size_t np= num_threads()==1 || n*n*m<size_t(1)<<22 ? 1 : std::min((m+63)/64,4*num_threads());
+    size_t w=(m+np-1)/np;
+    np=(m+w-1)/w;
+    auto panel=[=](size_t p)
+    {
+        size_t l0=p*w, nl=std::min(w,m-l0);
+        const T* b=B+l0*csb;
+        T* c=C+l0*csc;
+        for (size_t l=0;l<nl;l++)
+            for (size_t i=0;i<n;i++)
+            {
+                T& cil=c[i*rsc+l*csc];
+                cil= beta==T(0) ? T(0) : beta*cil;
+            }
+        std::valarray<T> tile(std::min(n,symm_tile)*std::min(n,symm_tile));
+        T* s=&tile[0];
+        for (size_t j0=0;j0<n;j0+=symm_tile)
+        {
+            size_t nj=std::min(symm_tile,n-j0);
+            for (size_t i0=0;i0<=j0;i0+=symm_tile)
+            {
+                size_t ni=std::min(symm_tile,n-i0);
+                // s(i,j)=S(i0+i,j0+j), column major with ld ni.  Column j0+j is stored down to row j0+j.
+                for (size_t j=0;j<nj;j++)
+                {
+                    const T* sj=S+(j0+j)*(j0+j+1)/2+i0;
+                    std::copy(sj,sj+std::min(ni,j0+j-i0+1),s+j*ni);
+                }
+                if (i0==j0) //Diagonal tile, mirror the lower half.
+                    for (size_t j=0;j<nj;j++)
+                        for (size_t i=j+1;i<ni;i++) s[i+j*ni]=s[j+i*ni];
+                gemm(ni,nl,nj,alpha,s,size_t(1),ni,b+j0*rsb,rsb,csb,T(1),c+i0*rsc,rsc,csc);
+                if (i0<j0)
+                    gemm(nj,nl,ni,alpha,s,ni,size_t(1),b+i0*rsb,rsb,csb,T(1),c+j0*rsc,rsc,csc);
+            }
+        }
+    };
+    if (np==1)
+        panel(0);
+    else
+        parallel_for(np,panel);
+}
+
+// Column block size for syrk, same trade off as the tiles in triangular_gemm.
+inline size_t syrk_block(size_t n) {return std::clamp<size_t>((n/8+15)/16*16,32,256);}
+
+// Run f(J) for the nb wide column blocks J of an n x n result.  Blocks are independent.
+template <class F> void syrk_blocks(size_t n, size_t k, size_t nb, F&& f)
+{
+    size_t nt=(n+nb-1)/nb;
+    if (num_threads()==1 || n*n*k<size_t(1)<<22)
+        for (size_t t=0;t<nt;t++) f(t*nb,std::min(n,(t+1)*nb));
+    else
+        parallel_for(nt,[&](size_t t) {f(t*nb,std::min(n,(t+1)*nb));});
+}
+
+//
+//  C=A*A^T, A is n x k, C is a full n x n matrix.  Each column block C(0:j1,j0:j1) is one gemm call,
+//  then the strict lower triangle is copied from the upper one.
+//
+template <class T> void syrk(size_t n, size_t k, const T* A, size_t rsa, size_t csa, T* C, size_t rsc, size_t csc)
+{
+    if (n==0) return;
+    syrk_blocks(n,k,syrk_block(n),[=](size_t j0, size_t j1)
+    {
+        gemm(j1,j1-j0,k,
+            T(1),A,rsa,csa,
+                 A+j0*rsa,csa,rsa, //B=A^T
+            T(0),C+j0*csc,rsc,csc);
+    });
+    for (size_t j=0;j<n;j++)
+        for (size_t i=j+1;i<n;i++)
+            C[i*rsc+j*csc]=C[j*rsc+i*csc];
+}
+
+//
+//  C=A*A^T, A is n x k, C is symmetric in packed upper storage.  Column blocks go through a
+//  buffer since packed columns don't have a fixed stride.
+//
+template <class T> void syrk_packed(size_t n, size_t k, const T* A, size_t rsa, size_t csa, T* C)
+{
+    if (n==0) return;
+    size_t nb=syrk_block(n);
+    syrk_blocks(n,k,nb,[=](size_t j0, size_t j1)
+    {
+        std::valarray<T> buf(j1*(j1-j0));
+        T* b=&buf[0];
+        gemm(j1,j1-j0,k,
+            T(1),A,rsa,csa,
+                 A+j0*rsa,csa,rsa,
+            T(0),b,size_t(1),j1);
+        for (size_t j=j0;j<j1;j++)
+            std::copy(b+(j-j0)*j1,b+(j-j0)*j1+j+1,C+j*(j+1)/2);
+    });
+}
+
+} //namespace matrix23::native
@@ -0,0 +1,182 @@
+// File: threads.hpp  Work stealing thread pool used to evaluate expressions in parallel.
+#pragma once
+
+#include <cstddef>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <exception>
+
+//
+//  The pool runs one parallel_for job at a time.  The tasks of a job are numbered 0..ntask-1 and
+//  dealt out round robin to a deque per worker.  Each worker pops from the front of its own deque
+//  and, when that runs dry, steals from the back of the other deques.  So unequal tasks,
+//  like the columns of a triangular product, still balance out.
+//  The calling thread works as worker 0, so num_threads()==1 means no extra threads at all.
+//  Nested calls (a task calling parallel_for), or calls made while another thread owns the pool,
+//  just run the tasks serially on the calling thread.
+//
+namespace matrix23
+{
+
+class ThreadPool
+{
+public:
+    static ThreadPool& instance()
+    {
+        static ThreadPool pool(std::max(1u,std::thread::hardware_concurrency()));
+        return pool;
+    }
+    ~ThreadPool() {stop_workers();}
+
+    size_t size() const {return queues.size();}
+    void resize(size_t n)
+    {
+        std::lock_guard<std::mutex> job_lock(job_mutex);
+        stop_workers();
+        start_workers(std::max(size_t(1),n));
+    }
+
+    template <class F> void parallel_for(size_t ntask, F&& f)
+    {
+        std::unique_lock<std::mutex> job_lock(job_mutex,std::try_to_lock);
+        if (ntask<=1 || size()==1 || in_task() || !job_lock.owns_lock())
+        {
+            for (size_t t=0;t<ntask;t++) f(t);
+            return;
+        }
+        // Set up the job before any task becomes visible in the queues.
+        remaining=ntask;
+        error=nullptr;
+        job=std::function<void(size_t)>(std::ref(f));
+        for (size_t t=0;t<ntask;t++)
+        {
+            Queue& q=*queues[t%size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(t);
+        }
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            generation++;
+        }
+        wake.notify_all();
+        run_tasks(0);
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        done.wait(lock,[this]{return remaining==0;});
+        job=nullptr;
+        if (error) std::rethrow_exception(error);
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    ThreadPool(size_t n) {start_workers(n);}
+
+    static bool& in_task() {thread_local bool flag=false; return flag;}
+
+    void start_workers(size_t n)
+    {
+        stopping=false;
+        for (size_t w=0;w<n;w++) queues.push_back(std::make_unique<Queue>());
+        for (size_t w=1;w<n;w++) workers.emplace_back([this,w,g=generation]{worker_loop(w,g);});
+    }
+    void stop_workers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping=true;
+        }
+        wake.notify_all();
+        for (auto& w:workers) w.join();
+        workers.clear();
+        queues.clear();
+    }
+    void worker_loop(size_t w, size_t seen)
+    {
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex);
+                wake.wait(lock,[this,seen]{return stopping || generation!=seen;});
+                if (stopping) return;
+                seen=generation;
+            }
+            run_tasks(w);
+        }
+    }
+    bool pop(size_t w, size_t& t) // Own deque from the front.
+    {
+        Queue& q=*queues[w];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        t=q.tasks.front();
+        q.tasks.pop_front();
+        return true;
+    }
+    bool steal(size_t w, size_t& t) // Someone else's deque from the back.
+    {
+        for (size_t i=1;i<size();i++)
+        {
+            Queue& q=*queues[(w+i)%size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.tasks.empty()) continue;
+            t=q.tasks.back();
+            q.tasks.pop_back();
+            return true;
+        }
+        return false;
+    }
+    void run_tasks(size_t w)
+    {
+        in_task()=true;
+        size_t t;
+        while (pop(w,t) || steal(w,t))
+        {
+            try
+            {
+                job(t);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                if (!error) error=std::current_exception();
+            }
+            if (--remaining==0)
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex);
+                done.notify_all();
+            }
+        }
+        in_task()=false;
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues; //One per worker, including the caller.
+    std::vector<std::thread> workers;
+    std::mutex job_mutex;  //Owned by the thread running the current parallel_for.
+    std::mutex wake_mutex;
+    std::condition_variable wake,done;
+    std::function<void(size_t)> job;
+    std::atomic<size_t> remaining{0};
+    std::exception_ptr error;
+    size_t generation=0;
+    bool stopping=false;
+};
+
+//
+//  User interface.  The default thread count is std::thread::hardware_concurrency().
+//
+inline void   set_num_threads(size_t n) {ThreadPool::instance().resize(n);}
+inline size_t num_threads() {return ThreadPool::instance().size();}
+// Run f(t) for t=0..ntask-1 on the pool and wait for all of them to finish.
+template <class F> void parallel_for(size_t ntask, F&& f) {ThreadPool::instance().parallel_for(ntask,std::forward<F>(f));}
+
+} //namespace matrix23
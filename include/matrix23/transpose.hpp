@@ -0,0 +1,115 @@
+// File: transpose.hpp  Native kernels for transposing and changing the layout of full matrices.
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include "matrix23/threads.hpp"
+
+//
+//  Copying a column major matrix into a row major one (or into the transpose) reads down columns
+//  and writes along rows, so one side always strides through memory.  Element by element that misses
+//  the cache on nearly every access once a column is bigger than a page.
+//      transpose   B[r*ldb+s]=A[r+s*lda].  Halves the longer side until the block fits in L1, so it
+//                  is cache oblivious.  The leaves write rows of B and read across A, whose lines are all
+//                  still in L1 for the next row.  Big matrices are cut into column blocks for the thread pool.
+//      transpose_square  In place, A=A^T for n x n.  Transposes the diagonal blocks recursively and
+//                  swaps the off diagonal ones.
+//      copy_2d     B(i,j)=A(i,j) for any (row stride, col stride) pair, i.e. CM<->RM and ~A.
+//                  Picks straight line copies or transpose from the strides.
+//
+namespace matrix23::native
+{
+
+inline constexpr size_t transpose_leaf=32; //32x32 doubles, 8K per side, stays in L1.
+
+// p x q block, B[r*ldb+s]=A[r+s*lda].  A and B don't overlap.
+template <class T> void transpose_block(size_t p, size_t q, const T* A, size_t lda, T* B, size_t ldb)
+{
+    if (p>transpose_leaf || q>transpose_leaf)
+    {
+        if (p>=q)
+        {
+            size_t h=p/2;
+            transpose_block(h  ,q,A  ,lda,B      ,ldb);
+            transpose_block(p-h,q,A+h,lda,B+h*ldb,ldb);
+        }
+        else
+        {
+            size_t h=q/2;
+            transpose_block(p,h  ,A      ,lda,B  ,ldb);
+            transpose_block(p,q-h,A+h*lda,lda,B+h,ldb);
+        }
+        return;
+    }
+    for (size_t r=0;r<p;r++)
+        for (size_t s=0;s<q;s++) B[r*ldb+s]=A[r+s*lda];
+}
+
+template <class T> void transpose(size_t p, size_t q, const T* A, size_t lda, T* B, size_t ldb)
+{
+    if (p==0 || q==0) return;
+    size_t ntask= p*q<(size_t(1)<<18) ? 1 : std::min(q/transpose_leaf+1,4*num_threads());
+    size_t nb=(q+ntask-1)/ntask;
+    parallel_for(ntask,[&](size_t t)
+    {
+        size_t s0=std::min(q,t*nb), s1=std::min(q,s0+nb);
+        transpose_block(p,s1-s0,A+s0*lda,lda,B+s0,ldb);
+    });
+}
+
+// Swap the p x q block X with the transpose of Y: X[r+s*ld] <-> Y[s+r*ld].
+template <class T> void transpose_swap(size_t p, size_t q, T* X, T* Y, size_t ld)
+{
+    if (p>transpose_leaf || q>transpose_leaf)
+    {
+        if (p>=q)
+        {
+            size_t h=p/2;
+            transpose_swap(h  ,q,X  ,Y     ,ld);
+            transpose_swap(p-h,q,X+h,Y+h*ld,ld);
+        }
+        else
+        {
+            size_t h=q/2;
+            transpose_swap(p,h  ,X     ,Y  ,ld);
+            transpose_swap(p,q-h,X+h*ld,Y+h,ld);
+        }
+        return;
+    }
+    for (size_t s=0;s<q;s++)
+        for (size_t r=0;r<p;r++) std::swap(X[r+s*ld],Y[s+r*ld]);
+}
+
+template <class T> void transpose_square(size_t n, T* A, size_t ld)
+{
+    if (n<=transpose_leaf)
+    {
+        for (size_t j=1;j<n;j++)
+            for (size_t i=0;i<j;i++) std::swap(A[i+j*ld],A[j+i*ld]);
+        return;
+    }
+    size_t h=n/2;
+    transpose_square(h  ,A         ,ld);
+    transpose_square(n-h,A+h+h*ld  ,ld);
+    transpose_swap  (h,n-h,A+h*ld,A+h,ld); //Upper right with lower left.
+}
+
+// m x n, B(i,j)=A(i,j) with A(i,j) at A[i*rsa+j*csa] and B(i,j) at B[i*rsb+j*csb].
+template <class T> void copy_2d(size_t m, size_t n, const T* A, size_t rsa, size_t csa, T* B, size_t rsb, size_t csb)
+{
+    if (m==0 || n==0) return;
+    if (rsa==1 && rsb==1)
+        for (size_t j=0;j<n;j++) std::copy_n(A+j*csa,m,B+j*csb);
+    else if (csa==1 && csb==1)
+        for (size_t i=0;i<m;i++) std::copy_n(A+i*rsa,n,B+i*rsb);
+    else if (rsa==1 && csb==1)
+        transpose(m,n,A,csa,B,rsb);
+    else if (csa==1 && rsb==1)
+        transpose(n,m,A,rsa,B,csb);
+    else
+        for (size_t j=0;j<n;j++)
+            for (size_t i=0;i<m;i++) B[i*rsb+j*csb]=A[i*rsa+j*csa];
+}
+
+} //namespace matrix23::native
@@ -0,0 +1,58 @@
+// File: trmm.hpp  Native blocked products with upper/lower triangular operands.
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include <utility>
+#include "matrix23/gemm.hpp"
+
+//
+//  C = alpha*A*B+beta*C where A and/or B are upper or lower triangular.  C is cut into square tiles.  For each tile
+//  only the slice of the inner index where both A(I,:) and B(:,J) can be non-zero is passed to
+//  native::gemm, and tiles that can only be zero are just scaled by beta.  So U*U does about 1/6 of the
+//  multiply-adds of a full product, U*L and U*F about 1/3 and 1/2.  Tiles are independent and go
+//  to the thread pool in the same way as parallel_gemm.
+//  A and B are (pointer, row stride, column stride) and must hold explicit zeros outside their shapes,
+//  tiles straddling the diagonal are multiplied as full blocks.
+//
+namespace matrix23::native
+{
+enum class shape {full, upper, lower};
+
+// Inner indices [first,second) that can contribute to C(i0:i1,j0:j1).
+inline std::pair<size_t,size_t> inner_range(shape sa, shape sb, size_t k, size_t i0, size_t i1, size_t j0, size_t j1)
+{
+    size_t l0=0, l1=k;
+    if (sa==shape::upper) l0=std::max(l0,i0); //A(i,l)!=0 needs i<=l
+    if (sa==shape::lower) l1=std::min(l1,i1); //A(i,l)!=0 needs l<=i
+    if (sb==shape::upper) l1=std::min(l1,j1); //B(l,j)!=0 needs l<=j
+    if (sb==shape::lower) l0=std::max(l0,j0); //B(l,j)!=0 needs j<=l
+    return {l0,std::max(l0,l1)};
+}
+
+template <class T> void triangular_gemm(size_t m, size_t n, size_t k,
+    T alpha, shape sa, const T* A, size_t rsa, size_t csa,
+             shape sb, const T* B, size_t rsb, size_t csb,
+    T beta ,                 T* C, size_t rsc, size_t csc)
+{
+    if (m==0 || n==0) return;
+    // Small tiles skip more zeros but make less efficient gemm calls.
+    size_t nb=std::clamp<size_t>((std::max(m,n)/8+15)/16*16,32,256);
+    size_t ntm=(m+nb-1)/nb, ntn=(n+nb-1)/nb;
+    auto tile=[&](size_t t)
+    {
+        size_t i0=(t%ntm)*nb, j0=(t/ntm)*nb;
+        size_t i1=std::min(m,i0+nb), j1=std::min(n,j0+nb);
+        auto [l0,l1]=inner_range(sa,sb,k,i0,i1,j0,j1);
+        gemm(i1-i0,j1-j0,l1-l0, //k=0 just scales the tile by beta.
+            alpha,A+i0*rsa+l0*csa,rsa,csa,
+                  B+l0*rsb+j0*csb,rsb,csb,
+            beta ,C+i0*rsc+j0*csc,rsc,csc);
+    };
+    if (num_threads()==1 || m*n*k<size_t(1)<<21)
+        for (size_t t=0;t<ntm*ntn;t++) tile(t);
+    else
+        parallel_for(ntm*ntn,tile);
+}
+
+} //namespace matrix23::native
@@ -2,9 +2,12 @@
 #pragma once
 
 #include "matrix23/ran250.h"
+#include "matrix23/simd.hpp"
+#include "matrix23/aligned.hpp"
 #include <valarray>
-// #include <vector>
+#include <array>
 #include <ranges>
+#include <functional>
 #include <cassert>
 
 namespace matrix23
@@ -21,9 +24,89 @@ concept isVector = requires (V v)
 
 typedef std::ranges::iota_view<size_t,size_t> iota_view;
 
+//
+//  The memory an expression reads, so that C=A*C can be caught before C is overwritten.
+//  Unknown spans overlap everything.
+//
+struct storage_span
+{
+    const void* lo=nullptr;
+    const void* hi=nullptr;
+    bool known=false;
+    bool overlaps(const storage_span& s) const
+    {
+        std::less<const void*> lt; //Total order, even for unrelated pointers.
+        return !known || !s.known || (lt(lo,s.hi) && lt(s.lo,hi));
+    }
+};
+// Storage of a stored matrix or vector, unknown for anything else.
+template <class M> storage_span storage_of(const M& m)
+{
+    if constexpr (requires {{m.storage()} -> std::same_as<storage_span>;})
+        return m.storage();
+    else
+        return {};
+}
+// Could evaluating m read memory in s?  Expressions that don't say are assumed to.
+template <class M> bool reads_from(const M& m, const storage_span& s)
+{
+    if constexpr (requires {{m.reads(s)} -> std::same_as<bool>;})
+        return m.reads(s);
+    else
+        return true;
+}
+//
+//  Vector expressions are evaluated element by element into the destination.  Element i of an elementwise
+//  view only reads element i of its operands, so y=y+x is safe in place.  Products read whole operands,
+//  they record them here and y=A*y goes through a temporary.  Nothing else mixes elements.
+//  A few spans are kept apart, so y isn't caught just for lying between A and x.  More are merged.
+//
+class mixed_spans
+{
+public:
+    bool overlaps(const storage_span& s) const
+    {
+        for (size_t k=0;k<n;k++)
+            if (spans[k].overlaps(s)) return true;
+        return false;
+    }
+    mixed_spans& add(const storage_span& s)
+    {
+        if (s.known && s.lo==s.hi) return *this; //Empty.
+        if (n<spans.size())
+            spans[n++]=s;
+        else if (!s.known || !spans[n-1].known)
+            spans[n-1]={};
+        else
+        {
+            std::less<const void*> lt;
+            storage_span& u=spans[n-1];
+            u={lt(u.lo,s.lo) ? u.lo : s.lo, lt(u.hi,s.hi) ? s.hi : u.hi, true};
+        }
+        return *this;
+    }
+    mixed_spans& add(const mixed_spans& m)
+    {
+        for (size_t k=0;k<m.n;k++) add(m.spans[k]);
+        return *this;
+    }
+private:
+    std::array<storage_span,4> spans;
+    size_t n=0;
+};
+template <class V> mixed_spans mixed_of(const V& v)
+{
+    if constexpr (requires {{v.mixed()} -> std::same_as<mixed_spans>;})
+        return v.mixed();
+    else
+        return {};
+}
 
 
-template <std::ranges::viewable_range R> class VectorView
+
+
+// A view, so adaptors over it (a+b, a*s ...) hold a copy rather than a reference to what may be a temporary row.
+template <std::ranges::viewable_range R> class VectorView : public std::ranges::view_base
 {
 public:
     typedef std::ranges::iota_view<size_t,size_t> iota_view; 
@@ -49,22 +132,32 @@ public:
     // many ranges don't support random access with op[].
     size_t size() const { return  itsIndices.size(); }
     iota_view indices() const { return itsIndices; }
+    mixed_spans mixed() const {return itsMixed;}
+    VectorView& mixing(const mixed_spans& m) {itsMixed=m; return *this;}
 private:
     R range; // only includes data for the non-zero portion of the vector.
     iota_view itsIndices;
+    mixed_spans itsMixed; //See mixed_spans.
 };
 
 enum fill_t {none, zero, one, value, random, unit};
 
 
-// template <typename T> using default_data_type=std::vector<T>;
-template <typename T> using default_data_type=std::valarray<T>;
+// template <typename T> using default_data_type=std::valarray<T>;
+template <typename T> using default_data_type=aligned_data<T>;
+// Storage for compile time sized matrices and vectors.  Constructed from a size like the others so
+// Matrix and Vector can use it unchanged.  Value initialized, i.e. zeros.
+template <typename T, size_t N> struct fixed_data : public std::array<T,N>
+{
+    constexpr fixed_data() : std::array<T,N>{} {}
+    constexpr explicit fixed_data([[maybe_unused]] size_t n) : std::array<T,N>{} {assert(n==N && "Fixed size storage can't be resized");}
+};
 
 
 template <class T, typename Data=default_data_type<T>> class Vector
 {
 public:
-    Vector() : Vector(0) {};
+    Vector() : data() {}; //Empty, or full size for fixed_data.
     Vector(size_t n) : Vector(n,none) {}
     Vector(size_t n, fill_t f, T v=T(1)) : data(n) 
     {
@@ -90,14 +183,37 @@ public:
     }
     Vector(const std::initializer_list<T>& init) : data(init.size()) {assign_from(init);}
     template <std::ranges::range R> 
-    Vector(const R& range) : data(range.size()) {assign_from(range);}
+    Vector(const R& range) : data(range.size()) {load(range,T(1),T(0));}
     template <std::ranges::range R> 
-    Vector(const VectorView<R>& view) : data(view.size()) {assign_from(view);}
+    Vector(const VectorView<R>& view) : data(view.size()) {load(view,T(1),T(0));}
+    //
+    //  Assignment reuses the storage when the size is unchanged.  If v mixes elements of this vector,
+    //  i.e. y=A*y, it goes through a temporary.  See mixed_spans.
+    //
     template <isVector V> Vector& operator=(const V& v)
     {
-        assign_from(v);
+        if (mixed_of(v).overlaps(storage()))
+            return *this=Vector(v);
+        if (size()!=v.size()) data=Data(v.size());
+        load(v,T(1),T(0));
+        return *this;
+    }
+    // this=alpha*v+beta*this in place.  beta=0 never reads the old values.  y+=A*x etc. end up here.
+    template <isVector V> Vector& update(T alpha, const V& v, T beta)
+    {
+        assert(size()==v.size());
+        if (mixed_of(v).overlaps(storage()))
+            load(Vector(v),alpha,beta);
+        else
+            load(v,alpha,beta);
         return *this;
     }
+    storage_span storage() const
+    {
+        if (size()==0) return {nullptr,nullptr,true};
+        const T* d=&*begin();
+        return {d,d+size(),true};
+    }
 
     T operator()(size_t i) const
     {
@@ -121,10 +237,26 @@ protected:
         size_t i=0;
         for (auto r:range) data[i++] = r; //This should be where the lazy evaluation of all the chained views happens.
     }
+    template <std::ranges::range V> void load(const V& v, T alpha, T beta)
+    {
+        if constexpr (requires (T* y) {{v.assign_to(y,alpha,beta)} -> std::same_as<bool>;})
+            if (size()==0 || v.assign_to(&*begin(),alpha,beta)) return; //i.e. gemv with alpha and beta.
+        if (alpha==T(1) && beta==T(0))
+            assign_from(v);
+        else
+        {
+            size_t i=0;
+            for (auto r:v)
+            {
+                T& y=data[i++];
+                y= beta==T(0) ? alpha*r : alpha*r+beta*y;
+            }
+        }
+    }
     void fillvalue(T v) {for (auto& i:data) i=v;}
     void fillrandom(T v) 
     {
-        if (v==1)
+        if (v==T(1))
             for (auto& i:data) i=OMLRandPos<T>();
         else
             for (auto& i:data) i=OMLRandPos<T>()*v;
@@ -132,14 +264,26 @@ protected:
     
     Data data;
 };
+template <class T, size_t N> using FixedVector=Vector<T,fixed_data<T,N>>;
+
 
+// Both ranges sit in memory back to back with the same element type, so we can use the simd kernels.
+template <class Range1, class Range2> concept isContiguousPair =
+    std::ranges::contiguous_range<const Range1> && std::ranges::contiguous_range<const Range2> &&
+    std::same_as<std::ranges::range_value_t<Range1>,std::ranges::range_value_t<Range2>> &&
+    simd::isSimdType<std::ranges::range_value_t<Range1>>;
 
 template <std::ranges::range Range1,std::ranges::range Range2> auto inner_product(const Range1& a, const Range2& b)
 {
     assert(a.size() == b.size() && "Ranges must be of the same size for dot product");
-    std::ranges::range_value_t<Range1> dot(0); //
-    for (auto [ia,ib]:std::views::zip(a,b)) dot += ia*ib;
-    return dot;
+    if constexpr (isContiguousPair<Range1,Range2>)
+        return simd::dot(std::ranges::data(a),std::ranges::data(b),std::ranges::size(a));
+    else
+    {
+        std::ranges::range_value_t<Range1> dot(0); //
+        for (auto [ia,ib]:std::views::zip(a,b)) dot += ia*ib;
+        return dot;
+    }
 } 
 
 struct intersection
@@ -175,24 +319,30 @@ auto operator+(const isVector auto& a, const isVector auto& b)
 {
     assert(a.size() == b.size() && "Vectors must be of the sam  e size for addition");
     auto ab=std::views::zip_transform([](const auto& ia, const auto& ib) { return ia + ib; },a,b);
-    return VectorView(std::move(ab));
+    return VectorView(std::move(ab)).mixing(mixed_of(a).add(mixed_of(b)));
 }
 auto operator-(const isVector auto& a, const isVector auto& b)
 {
     assert(a.size() == b.size() && "Vectors must be of the sam  e size for addition");
-    return VectorView(std::views::zip_transform([](const auto& ia, const auto& ib) { return ia - ib; },a,b));
+    return VectorView(std::views::zip_transform([](const auto& ia, const auto& ib) { return ia - ib; },a,b)).mixing(mixed_of(a).add(mixed_of(b)));
 }
 
-template <typename T> auto& operator+=(Vector<T>& a, const isVector auto& b)
+template <typename T, isVector V> auto& operator+=(Vector<T>& a, const V& b)
 {
-    auto ib=b.begin();
-    for (auto& ia:a) ia+=*ib++;
+    assert(a.size() == b.size() && "Vectors must be of the same size for addition");
+    if constexpr (isContiguousPair<Vector<T>,V>)
+        simd::axpy(T(1),std::ranges::data(b),std::ranges::data(a),a.size());
+    else
+        a.update(T(1),b,T(1));
     return a;
 }
-template <typename T> auto& operator-=(Vector<T>& a, const isVector auto& b)
+template <typename T, isVector V> auto& operator-=(Vector<T>& a, const V& b)
 {
-    auto ib=b.begin();
-    for (auto& ia:a) ia-=*ib++;
+    assert(a.size() == b.size() && "Vectors must be of the same size for subtraction");
+    if constexpr (isContiguousPair<Vector<T>,V>)
+        simd::axpy(T(-1),std::ranges::data(b),std::ranges::data(a),a.size());
+    else
+        a.update(T(-1),b,T(1));
     return a;
 }
 
@@ -201,15 +351,15 @@ template <typename T> concept arithmetic = std::integral<T> || std::floating_poi
 
 auto operator*(const isVector auto& a, const arithmetic auto& b)
 {
-    return VectorView(std::views::transform(a,[b](const auto& ia) { return ia*b; }));
+    return VectorView(std::views::transform(a,[b](const auto& ia) { return ia*b; })).mixing(mixed_of(a));
 }
 auto operator*(const arithmetic auto& b,const isVector auto& a)
 {
-    return VectorView(std::views::transform(a,[b](const auto& ia) { return b*ia; }));
+    return VectorView(std::views::transform(a,[b](const auto& ia) { return b*ia; })).mixing(mixed_of(a));
 }
 auto operator/(const isVector auto& a, const arithmetic auto& b)
 {
-    return VectorView(std::views::transform(a,[b](const auto& ia) { return ia/b; }));
+    return VectorView(std::views::transform(a,[b](const auto& ia) { return ia/b; })).mixing(mixed_of(a));
 }
 
 template <typename T> auto& operator+=(Vector<T>& a, const arithmetic auto& b)
@@ -1,159 +1,414 @@
 // File: blas.cpp  Interface for calling blass using matrix23 containers
 
 #include "matrix23/blas.hpp"
+#include <algorithm>
+#include <complex>
+
+typedef std::complex<float > cfloat;
+typedef std::complex<double> cdouble;
 extern"C" {
-void dgemv_(char* trans,int* m,int* n,double* alpha, const double* A,int* lda, const double* x, int* incx, double* beta, double* y, int* incy);
-void dtpmv_(char* uplo, char* trans, char* diag, int* n, const double* A, double* x,  int* incx);
-void dgbmv_(char* trans,int* m,int* n,int* kl,int* ku,double* alpha,const double*A ,int* lda,const double* x,int* incx,double* beta,double* y,int* incy);
+void sgemv_(char* trans,int* m,int* n,float  * alpha, const float  * A,int* lda, const float  * x, int* incx, float  * beta, float  * y, int* incy);
+void dgemv_(char* trans,int* m,int* n,double * alpha, const double * A,int* lda, const double * x, int* incx, double * beta, double * y, int* incy);
+void cgemv_(char* trans,int* m,int* n,cfloat * alpha, const cfloat * A,int* lda, const cfloat * x, int* incx, cfloat * beta, cfloat * y, int* incy);
+void zgemv_(char* trans,int* m,int* n,cdouble* alpha, const cdouble* A,int* lda, const cdouble* x, int* incx, cdouble* beta, cdouble* y, int* incy);
+void stpmv_(char* uplo, char* trans, char* diag, int* n, const float  * A, float  * x,  int* incx);
+void dtpmv_(char* uplo, char* trans, char* diag, int* n, const double * A, double * x,  int* incx);
+void ctpmv_(char* uplo, char* trans, char* diag, int* n, const cfloat * A, cfloat * x,  int* incx);
+void ztpmv_(char* uplo, char* trans, char* diag, int* n, const cdouble* A, cdouble* x,  int* incx);
+void sgbmv_(char* trans,int* m,int* n,int* kl,int* ku,float  * alpha,const float  * A,int* lda,const float  * x,int* incx,float  * beta,float  * y,int* incy);
+void dgbmv_(char* trans,int* m,int* n,int* kl,int* ku,double * alpha,const double * A,int* lda,const double * x,int* incx,double * beta,double * y,int* incy);
+void cgbmv_(char* trans,int* m,int* n,int* kl,int* ku,cfloat * alpha,const cfloat * A,int* lda,const cfloat * x,int* incx,cfloat * beta,cfloat * y,int* incy);
+void zgbmv_(char* trans,int* m,int* n,int* kl,int* ku,cdouble* alpha,const cdouble* A,int* lda,const cdouble* x,int* incx,cdouble* beta,cdouble* y,int* incy);
 
-void dgemm_( char* transa,char* transb,int* m,int* n,int* k,double* alpha,const double* A,int* lda,const double* B,int* ldb,double* beta, double* C,int* ldc );
+void sgemm_( char* transa,char* transb,int* m,int* n,int* k,float  * alpha,const float  * A,int* lda,const float  * B,int* ldb,float  * beta, float  * C,int* ldc );
+void dgemm_( char* transa,char* transb,int* m,int* n,int* k,double * alpha,const double * A,int* lda,const double * B,int* ldb,double * beta, double * C,int* ldc );
+void cgemm_( char* transa,char* transb,int* m,int* n,int* k,cfloat * alpha,const cfloat * A,int* lda,const cfloat * B,int* ldb,cfloat * beta, cfloat * C,int* ldc );
+void zgemm_( char* transa,char* transb,int* m,int* n,int* k,cdouble* alpha,const cdouble* A,int* lda,const cdouble* B,int* ldb,cdouble* beta, cdouble* C,int* ldc );
 // dtrmm_ would be for full packing and triangular shape.  i.e. lower zeros are stored but not refrenced.
-void dtrmm_( char* side,char* uplo,char* transa,char* diag,int* m,int* n,double* alpha,const double*A,int* lda,const double*B,int* ldb );
+void strmm_( char* side,char* uplo,char* transa,char* diag,int* m,int* n,float  * alpha,const float  * A,int* lda,const float  * B,int* ldb );
+void dtrmm_( char* side,char* uplo,char* transa,char* diag,int* m,int* n,double * alpha,const double * A,int* lda,const double * B,int* ldb );
+void ctrmm_( char* side,char* uplo,char* transa,char* diag,int* m,int* n,cfloat * alpha,const cfloat * A,int* lda,const cfloat * B,int* ldb );
+void ztrmm_( char* side,char* uplo,char* transa,char* diag,int* m,int* n,cdouble* alpha,const cdouble* A,int* lda,const cdouble* B,int* ldb );
+// Symmetric.  Complex spmv/symv are only in lapack, blas has the hermitian hpmv/hemv instead.
+void sspmv_(char* uplo,int* n,float  * alpha,const float  * Ap,const float  * x,int* incx,float  * beta,float  * y,int* incy);
+void dspmv_(char* uplo,int* n,double * alpha,const double * Ap,const double * x,int* incx,double * beta,double * y,int* incy);
+void ssymv_(char* uplo,int* n,float  * alpha,const float  * A,int* lda,const float  * x,int* incx,float  * beta,float  * y,int* incy);
+void dsymv_(char* uplo,int* n,double * alpha,const double * A,int* lda,const double * x,int* incx,double * beta,double * y,int* incy);
+void ssymm_( char* side,char* uplo,int* m,int* n,float  * alpha,const float  * A,int* lda,const float  * B,int* ldb,float  * beta,float  * C,int* ldc );
+void dsymm_( char* side,char* uplo,int* m,int* n,double * alpha,const double * A,int* lda,const double * B,int* ldb,double * beta,double * C,int* ldc );
+void csymm_( char* side,char* uplo,int* m,int* n,cfloat * alpha,const cfloat * A,int* lda,const cfloat * B,int* ldb,cfloat * beta,cfloat * C,int* ldc );
+void zsymm_( char* side,char* uplo,int* m,int* n,cdouble* alpha,const cdouble* A,int* lda,const cdouble* B,int* ldb,cdouble* beta,cdouble* C,int* ldc );
+void ssyrk_( char* uplo,char* trans,int* n,int* k,float  * alpha,const float  * A,int* lda,float  * beta,float  * C,int* ldc );
+void dsyrk_( char* uplo,char* trans,int* n,int* k,double * alpha,const double * A,int* lda,double * beta,double * C,int* ldc );
+void csyrk_( char* uplo,char* trans,int* n,int* k,cfloat * alpha,const cfloat * A,int* lda,cfloat * beta,cfloat * C,int* ldc );
+void zsyrk_( char* uplo,char* trans,int* n,int* k,cdouble* alpha,const cdouble* A,int* lda,cdouble* beta,cdouble* C,int* ldc );
 }
 
 namespace matrix23 {
+//
+//  Pick the s/d/c/z flavour of each routine from the element type.  Fortran complex and std::complex
+//  have the same layout.  Note 'T' is a plain transpose for complex types, not the conjugate.
+//
+template <class T> struct blas;
+template <> struct blas<float  >
+{
+    static constexpr auto gemv=sgemv_;
+    static constexpr auto tpmv=stpmv_;
+    static constexpr auto gbmv=sgbmv_;
+    static constexpr auto gemm=sgemm_;
+    static constexpr auto trmm=strmm_;
+    static constexpr auto spmv=sspmv_;
+    static constexpr auto symv=ssymv_;
+    static constexpr auto symm=ssymm_;
+    static constexpr auto syrk=ssyrk_;
+};
+template <> struct blas<double >
+{
+    static constexpr auto gemv=dgemv_;
+    static constexpr auto tpmv=dtpmv_;
+    static constexpr auto gbmv=dgbmv_;
+    static constexpr auto gemm=dgemm_;
+    static constexpr auto trmm=dtrmm_;
+    static constexpr auto spmv=dspmv_;
+    static constexpr auto symv=dsymv_;
+    static constexpr auto symm=dsymm_;
+    static constexpr auto syrk=dsyrk_;
+};
+template <> struct blas<cfloat >
+{
+    static constexpr auto gemv=cgemv_;
+    static constexpr auto tpmv=ctpmv_;
+    static constexpr auto gbmv=cgbmv_;
+    static constexpr auto gemm=cgemm_;
+    static constexpr auto trmm=ctrmm_;
+    static constexpr auto symm=csymm_;
+    static constexpr auto syrk=csyrk_;
+};
+template <> struct blas<cdouble>
+{
+    static constexpr auto gemv=zgemv_;
+    static constexpr auto tpmv=ztpmv_;
+    static constexpr auto gbmv=zgbmv_;
+    static constexpr auto gemm=zgemm_;
+    static constexpr auto trmm=ztrmm_;
+    static constexpr auto symm=zsymm_;
+    static constexpr auto syrk=zsyrk_;
+};
+
 
-template <> void gemv(double alpha, const FullMatrixCM<double>& A, const Vector<double>& x, double beta, Vector<double>& y )
+// Leading dimension of full storage, padding included.  blas wants at least 1.
+template <class M> int leading_dim(const M& A) {return std::max<int>(A.packer().ld(),1);}
+
+template <class T> void gemv(T alpha, const FullMatrixCM<T>& A, const Vector<T>& x, T beta, Vector<T>& y )
 {
     assert(A.nc()==x.size());
     assert(A.nr()==y.size());
     char trans='N'; //Don't transpose A.
-    int m=A.nr(),n=A.nc(),inc=1;
-    dgemv_(&trans,&m,&n,&alpha,&*A.begin(),&m,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+    int m=A.nr(),n=A.nc(),lda=leading_dim(A),inc=1;
+    blas<T>::gemv(&trans,&m,&n,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
 }
-template <> void gemv(double alpha, const FullMatrixRM<double>& A, const Vector<double>& x, double beta, Vector<double>& y )
+template <class T> void gemv(T alpha, const FullMatrixRM<T>& A, const Vector<T>& x, T beta, Vector<T>& y )
 {
     assert(A.nc()==x.size());
     assert(A.nr()==y.size());
     char trans='T'; //Don't transpose A.
-    int m=A.nc(),n=A.nr(),inc=1;
-    dgemv_(&trans,&m,&n,&alpha,&*A.begin(),&m,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+    int m=A.nc(),n=A.nr(),lda=leading_dim(A),inc=1;
+    blas<T>::gemv(&trans,&m,&n,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
 }
-template <> void gevm(double alpha, const FullMatrixCM<double>& A, const Vector<double>& x, double beta, Vector<double>& y )
+template <class T> void gevm(T alpha, const FullMatrixCM<T>& A, const Vector<T>& x, T beta, Vector<T>& y )
 {
     assert(A.nr()==x.size());
     assert(A.nc()==y.size());
     char trans='T'; //Do transpose A.
-    int m=A.nr(),n=A.nc(),inc=1;
-    dgemv_(&trans,&m,&n,&alpha,&*A.begin(),&m,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+    int m=A.nr(),n=A.nc(),lda=leading_dim(A),inc=1;
+    blas<T>::gemv(&trans,&m,&n,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
 }
-template <> void gevm(double alpha, const FullMatrixRM<double>& A, const Vector<double>& x, double beta, Vector<double>& y )
+template <class T> void gevm(T alpha, const FullMatrixRM<T>& A, const Vector<T>& x, T beta, Vector<T>& y )
 {
     assert(A.nr()==x.size());
     assert(A.nc()==y.size());
     char trans='N'; //Don't transpose A.
-    int m=A.nc(),n=A.nr(),inc=1;
-    dgemv_(&trans,&m,&n,&alpha,&*A.begin(),&m,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+    int m=A.nc(),n=A.nr(),lda=leading_dim(A),inc=1;
+    blas<T>::gemv(&trans,&m,&n,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
 }
 
 
-template <> void tpmv(const UpperTriangularMatrixCM<double>& A, Vector<double>& x)
+template <class T> void tpmv(const UpperTriangularMatrixCM<T>& A, Vector<T>& x)
 {
     assert(A.nc()==x.size());
     assert(A.nr()==x.size());
     char uplo='U', trans='N', diag='N'; //A is upper tri, Don't transpose A, A is not a diagonal unit.
     int n=A.nc(),inc=1;
-    dtpmv_(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
+    blas<T>::tpmv(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
 }
-template <> void tpmv(const UpperTriangularMatrixRM<double>& A, Vector<double>& x)
+template <class T> void tpmv(const UpperTriangularMatrixRM<T>& A, Vector<T>& x)
 {
     assert(A.nc()==x.size());
     assert(A.nr()==x.size());
     char uplo='L', trans='T', diag='N'; //Transposed and pretent lower for row major packing.
     int n=A.nc(),inc=1;
-    dtpmv_(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
+    blas<T>::tpmv(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
 }
-template <> void tpmv(const LowerTriangularMatrixCM<double>& A, Vector<double>& x)
+template <class T> void tpmv(const LowerTriangularMatrixCM<T>& A, Vector<T>& x)
 {
     assert(A.nc()==x.size());
     assert(A.nr()==x.size());
     char uplo='L', trans='N', diag='N'; //A is lower tri, Don't transpose A, A is not a diagonal unit.
     int n=A.nc(),inc=1;
-    dtpmv_(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
+    blas<T>::tpmv(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
 }
-template <> void tpmv(const LowerTriangularMatrixRM<double>& A, Vector<double>& x)
+template <class T> void tpmv(const LowerTriangularMatrixRM<T>& A, Vector<T>& x)
 {
     assert(A.nc()==x.size());
     assert(A.nr()==x.size());
     char uplo='U', trans='T', diag='N'; //Pretend A is upper tri, transpose A for row major packing.
     int n=A.nc(),inc=1;
-    dtpmv_(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
+    blas<T>::tpmv(&uplo,&trans,&diag,&n,&*A.begin(),&*x.begin(),&inc);
 }
-template <> void gbmv(double alpha, const SBandMatrix<double>& A, const Vector<double>& x, double beta, Vector<double>& y )
+template <class T> void gbmv(T alpha, const SBandMatrix<T>& A, const Vector<T>& x, T beta, Vector<T>& y )
 {
     assert(A.nc()==x.size());
     assert(A.nr()==y.size());
     char trans='N'; //Don't transpose A.
     int m=A.nr(),n=A.nc(),k=A.bandwidth(),lda=2*k+1,inc=1;
-    dgbmv_(&trans,&m,&n,&k,&k,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+    blas<T>::gbmv(&trans,&m,&n,&k,&k,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
 }
-template <> void gbvm(double alpha, const SBandMatrix<double>& A, const Vector<double>& x, double beta, Vector<double>& y )
+template <class T> void gbvm(T alpha, const SBandMatrix<T>& A, const Vector<T>& x, T beta, Vector<T>& y )
 {
     assert(A.nr()==x.size());
     assert(A.nc()==y.size());
     char trans='T'; //Don't transpose A.
     int m=A.nr(),n=A.nc(),k=A.bandwidth(),lda=2*k+1,inc=1;
-    dgbmv_(&trans,&m,&n,&k,&k,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+    blas<T>::gbmv(&trans,&m,&n,&k,&k,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
 }
 
-template <> void gemm(double alpha, const FullMatrixCM<double>& A, const FullMatrixCM<double>& B, double beta, FullMatrixCM<double>& C )
+//
+//  Row major data is the transpose of column major data with the same leading dimension.  So a row major
+//  A or B is passed as trans='T' instead of being copied.  For a row major C we have dgemm compute
+//  C^T=B^T*A^T, which swaps the A and B arguments and flips their trans flags.
+//  Operands are given as (pointer, row stride, column stride) like native::gemm, one stride must be 1.
+//
+struct blas_operand
+{
+    blas_operand(size_t nr, size_t nc, size_t rs, size_t cs)
+    {
+        if (rs==1) //Column major, or a single row/col.
+        {
+            trans='N';
+            ld=std::max({cs,nr,size_t(1)});
+        }
+        else
+        {
+            assert(cs==1 && "blas needs unit stride along rows or columns");
+            trans='T';
+            ld=std::max({rs,nc,size_t(1)});
+        }
+    }
+    char flipped() const {return trans=='N' ? 'T' : 'N';}
+    char trans;
+    int ld;
+};
+
+template <class T> void gemm_strided(size_t m, size_t n, size_t k,
+    T alpha, const T* A, size_t rsa, size_t csa,
+             const T* B, size_t rsb, size_t csb,
+    T beta ,       T* C, size_t rsc, size_t csc)
+{
+    if (m==0 || n==0) return;
+    blas_operand a(m,k,rsa,csa), b(k,n,rsb,csb), c(m,n,rsc,csc);
+    int im=m,in=n,ik=k;
+    if (c.trans=='N')
+    {
+        blas<T>::gemm(&a.trans,&b.trans,&im,&in,&ik,&alpha,A,&a.ld,B,&b.ld,&beta,C,&c.ld);
+    }
+    else
+    {
+        char transa=a.flipped(), transb=b.flipped();
+        blas<T>::gemm(&transb,&transa,&in,&im,&ik,&alpha,B,&b.ld,A,&a.ld,&beta,C,&c.ld);
+    }
+}
+
+template <class T, class Ma, class Mb, class Mc> void full_gemm(T alpha, const Ma& A, const Mb& B, T beta, Mc& C)
 {
     assert(A.nc()==B.nr());
     assert(A.nr()==C.nr());
     assert(B.nc()==C.nc());
-    char transa='N', transb='N'; //Don't transpose A or B.
-    int m=A.nr(),k=A.nc(),n=B.nc();
-    dgemm_(&transa,&transb,&m,&n,&k,&alpha,&*A.begin(),&m,&*B.begin(),&k,&beta,&*C.begin(),&m);
-}
-//Don't transpose A or B.  The swap A<-->B in the dgemm call!
-// Not working.
-// template <> void gemm(double alpha, const FullMatrixRM<double>& B, const FullMatrixRM<double>& A, double beta, FullMatrixRM<double>& C )
-// {
-//     assert(B.nc()==A.nr());
-//     assert(B.nr()==C.nr());
-//     assert(A.nc()==C.nc());
-//     char transa='T', transb='T'; 
-//     int m=A.nc(),k=A.nr(),n=B.nr();
-//     std::cout << "m,k,n=" << m << " " << k << " " << n << std::endl;
-//     dgemm_(&transa,&transb,&m,&n,&k,&alpha,A.begin(),&k,B.begin(),&n,&beta,C.begin(),&m);
-// }
-
-template <> void trmm(double alpha, const UpperTriangularMatrixFCM<double>& A, FullMatrixCM<double>& B)
+    if (C.size()==0) return;
+    auto pa=A.packer();
+    auto pb=B.packer();
+    auto pc=C.packer();
+    const T* a_data= A.size()>0 ? &*A.begin() : nullptr; //k==0, dgemm only scales C.
+    const T* b_data= B.size()>0 ? &*B.begin() : nullptr;
+    gemm_strided(A.nr(),B.nc(),A.nc(),
+        alpha,a_data,pa.row_stride(),pa.col_stride(),
+              b_data,pb.row_stride(),pb.col_stride(),
+        beta ,&*C.begin(),pc.row_stride(),pc.col_stride());
+}
+
+template <class T> void gemm(size_t m, size_t n, size_t k, T alpha, strided_data<const T> A, strided_data<const T> B, T beta, strided_data<T> C)
+{
+    gemm_strided(m,n,k,alpha,A.data,A.rs,A.cs,B.data,B.rs,B.cs,beta,C.data,C.rs,C.cs);
+}
+// Row major A is passed as A^T with trans='T', which is n x m.
+template <class T> void gemv(size_t m, size_t n, T alpha, strided_data<const T> A, const T* x, T beta, T* y)
+{
+    if (m==0) return;
+    blas_operand a(m,n,A.rs,A.cs);
+    int im=m,in=n,inc=1;
+    if (a.trans=='N')
+        blas<T>::gemv(&a.trans,&im,&in,&alpha,A.data,&a.ld,x,&inc,&beta,y,&inc);
+    else
+        blas<T>::gemv(&a.trans,&in,&im,&alpha,A.data,&a.ld,x,&inc,&beta,y,&inc);
+}
+
+template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixCM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixCM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixCM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixCM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixRM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+template <class T> void gemm(T alpha, const FullMatrixCM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixRM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixRM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+template <class T> void gemm(T alpha, const FullMatrixRM<T>& A, const FullMatrixRM<T>& B, T beta, FullMatrixRM<T>& C ) {full_gemm(alpha,A,B,beta,C);}
+
+template <class T> void trmm(T alpha, const UpperTriangularMatrixFCM<T>& A, FullMatrixCM<T>& B)
 {
     assert(A.nc()==B.nr());
     assert(A.nc()==A.nr()); //A has to square.
     
     char side='L',uplo='U',transa='N', diag='N'; //A*B, A upper, don't tranpose A, A is not diagonal.
-    int m=B.nr(),lda=A.nr(),n=B.nc();
-    dtrmm_(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&m);
+    int m=B.nr(),n=B.nc(),lda=leading_dim(A),ldb=leading_dim(B);
+    blas<T>::trmm(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&ldb);
 }
-template <> void trmm(double alpha, FullMatrixCM<double>& B, const UpperTriangularMatrixFCM<double>& A)
+template <class T> void trmm(T alpha, FullMatrixCM<T>& B, const UpperTriangularMatrixFCM<T>& A)
 {
     assert(A.nr()==B.nc());
     assert(A.nc()==A.nr()); //A has to square.
     
     char side='R',uplo='U',transa='N', diag='N'; //B*A, A upper, don't tranpose A, A is not diagonal.
-    int m=B.nr(),lda=A.nr(),n=B.nc();
-    dtrmm_(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&m);
+    int m=B.nr(),n=B.nc(),lda=leading_dim(A),ldb=leading_dim(B);
+    blas<T>::trmm(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&ldb);
 }
-template <> void trmm(double alpha, const LowerTriangularMatrixFCM<double>& A, FullMatrixCM<double>& B)
+template <class T> void trmm(T alpha, const LowerTriangularMatrixFCM<T>& A, FullMatrixCM<T>& B)
 {
     assert(A.nc()==B.nr());
     assert(A.nc()==A.nr()); //A has to square.
     
     char side='L',uplo='L',transa='N', diag='N'; //A*B, A lower, don't tranpose A, A is not diagonal.
-    int m=B.nr(),lda=A.nr(),n=B.nc();
-    dtrmm_(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&m);
+    int m=B.nr(),n=B.nc(),lda=leading_dim(A),ldb=leading_dim(B);
+    blas<T>::trmm(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&ldb);
 }
-template <> void trmm(double alpha, FullMatrixCM<double>& B, const LowerTriangularMatrixFCM<double>& A)
+template <class T> void trmm(T alpha, FullMatrixCM<T>& B, const LowerTriangularMatrixFCM<T>& A)
 {
     assert(A.nr()==B.nc());
     assert(A.nc()==A.nr()); //A has to square.
     
     char side='R',uplo='L',transa='N', diag='N'; //B*A, A upper, don't tranpose A, A is not diagonal.
-    int m=B.nr(),lda=A.nr(),n=B.nc();
-    dtrmm_(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&m);
+    int m=B.nr(),n=B.nc(),lda=leading_dim(A),ldb=leading_dim(B);
+    blas<T>::trmm(&side, &uplo,&transa,&diag,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&ldb);
+}
+
+//
+//  Symmetric A.  spmv reads the packed upper triangle, symv and symm the upper triangle of full storage.
+//
+template <class T> void spmv(T alpha, const SymmetricMatrixCM<T>& A, const Vector<T>& x, T beta, Vector<T>& y)
+{
+    assert(A.nc()==x.size());
+    assert(A.nr()==y.size());
+    char uplo='U'; //Upper triangle packed column by column.
+    int n=A.nr(),inc=1;
+    blas<T>::spmv(&uplo,&n,&alpha,&*A.begin(),&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+}
+template <class T> void symv(T alpha, const SymmetricMatrixFCM<T>& A, const Vector<T>& x, T beta, Vector<T>& y)
+{
+    assert(A.nc()==x.size());
+    assert(A.nr()==y.size());
+    char uplo='U';
+    int n=A.nr(),lda=leading_dim(A),inc=1;
+    blas<T>::symv(&uplo,&n,&alpha,&*A.begin(),&lda,&*x.begin(),&inc,&beta,&*y.begin(),&inc);
+}
+template <class T> void symm(T alpha, const SymmetricMatrixFCM<T>& A, const FullMatrixCM<T>& B, T beta, FullMatrixCM<T>& C)
+{
+    assert(A.nc()==B.nr());
+    assert(A.nr()==C.nr() && B.nc()==C.nc());
+    char side='L',uplo='U'; //A*B, use the upper triangle of A.
+    int m=C.nr(),n=C.nc(),lda=leading_dim(A),ldb=leading_dim(B),ldc=leading_dim(C);
+    blas<T>::symm(&side,&uplo,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&ldb,&beta,&*C.begin(),&ldc);
 }
+template <class T> void symm(T alpha, const FullMatrixCM<T>& B, const SymmetricMatrixFCM<T>& A, T beta, FullMatrixCM<T>& C)
+{
+    assert(B.nc()==A.nr());
+    assert(B.nr()==C.nr() && A.nc()==C.nc());
+    char side='R',uplo='U'; //B*A, use the upper triangle of A.
+    int m=C.nr(),n=C.nc(),lda=leading_dim(A),ldb=leading_dim(B),ldc=leading_dim(C);
+    blas<T>::symm(&side,&uplo,&m,&n,&alpha,&*A.begin(),&lda,&*B.begin(),&ldb,&beta,&*C.begin(),&ldc);
+}
+template <class T> void syrk(T alpha, const FullMatrixCM<T>& A, T beta, SymmetricMatrixFCM<T>& C)
+{
+    assert(A.nr()==C.nr() && C.nr()==C.nc());
+    char uplo='U',trans='N'; //C=alpha*A*A^T+beta*C
+    int n=A.nr(),k=A.nc(),lda=leading_dim(A),ldc=leading_dim(C);
+    blas<T>::syrk(&uplo,&trans,&n,&k,&alpha,&*A.begin(),&lda,&beta,&*C.begin(),&ldc);
+    // syrk only updates the upper triangle, but C stores both.
+    T* c=&*C.begin();
+    for (int j=0;j<n;j++)
+        for (int i=j+1;i<n;i++)
+            c[i+j*ldc]=c[j+i*ldc];
+}
+
+template <class T> void set_offload(size_t n)
+{
+    gemm_offload<T>::gemm= n>0 ? gemm_strided<T> : nullptr;
+    gemm_offload<T>::min_mnk=n*n*n;
+}
+void set_blas_offload(size_t n)
+{
+    set_offload<float >(n);
+    set_offload<double>(n);
+    set_offload<std::complex<float >>(n);
+    set_offload<std::complex<double>>(n);
+}
+
+//
+//  The templates above are only compiled here, for the four types blas supports.
+//
+#define MATRIX23_BLAS_INSTANTIATE(T) \
+template void gemv(T,const FullMatrixCM<T>&,const Vector<T>&,T,Vector<T>&); \
+template void gevm(T,const FullMatrixCM<T>&,const Vector<T>&,T,Vector<T>&); \
+template void gemv(T,const FullMatrixRM<T>&,const Vector<T>&,T,Vector<T>&); \
+template void gevm(T,const FullMatrixRM<T>&,const Vector<T>&,T,Vector<T>&); \
+template void gbmv(T,const  SBandMatrix<T>&,const Vector<T>&,T,Vector<T>&); \
+template void gbvm(T,const  SBandMatrix<T>&,const Vector<T>&,T,Vector<T>&); \
+template void tpmv(const UpperTriangularMatrixCM<T>&,Vector<T>&); \
+template void tpmv(const UpperTriangularMatrixRM<T>&,Vector<T>&); \
+template void tpmv(const LowerTriangularMatrixCM<T>&,Vector<T>&); \
+template void tpmv(const LowerTriangularMatrixRM<T>&,Vector<T>&); \
+template void gemm(size_t,size_t,size_t,T,strided_data<const T>,strided_data<const T>,T,strided_data<T>); \
+template void gemv(size_t,size_t,T,strided_data<const T>,const T*,T,T*); \
+template void gemm(T,const FullMatrixCM<T>&,const FullMatrixCM<T>&,T,FullMatrixCM<T>&); \
+template void gemm(T,const FullMatrixCM<T>&,const FullMatrixRM<T>&,T,FullMatrixCM<T>&); \
+template void gemm(T,const FullMatrixRM<T>&,const FullMatrixCM<T>&,T,FullMatrixCM<T>&); \
+template void gemm(T,const FullMatrixRM<T>&,const FullMatrixRM<T>&,T,FullMatrixCM<T>&); \
+template void gemm(T,const FullMatrixCM<T>&,const FullMatrixCM<T>&,T,FullMatrixRM<T>&); \
+template void gemm(T,const FullMatrixCM<T>&,const FullMatrixRM<T>&,T,FullMatrixRM<T>&); \
+template void gemm(T,const FullMatrixRM<T>&,const FullMatrixCM<T>&,T,FullMatrixRM<T>&); \
+template void gemm(T,const FullMatrixRM<T>&,const FullMatrixRM<T>&,T,FullMatrixRM<T>&); \
+template void trmm(T,const UpperTriangularMatrixFCM<T>&,FullMatrixCM<T>&); \
+template void trmm(T,const LowerTriangularMatrixFCM<T>&,FullMatrixCM<T>&); \
+template void trmm(T,FullMatrixCM<T>&,const UpperTriangularMatrixFCM<T>&); \
+template void trmm(T,FullMatrixCM<T>&,const LowerTriangularMatrixFCM<T>&); \
+template void symm(T,const SymmetricMatrixFCM<T>&,const FullMatrixCM<T>&,T,FullMatrixCM<T>&); \
+template void symm(T,const FullMatrixCM<T>&,const SymmetricMatrixFCM<T>&,T,FullMatrixCM<T>&); \
+template void syrk(T,const FullMatrixCM<T>&,T,SymmetricMatrixFCM<T>&);
+// No complex symmetric matrix*vector in blas.
+#define MATRIX23_BLAS_INSTANTIATE_REAL(T) \
+template void spmv(T,const SymmetricMatrixCM<T>&,const Vector<T>&,T,Vector<T>&); \
+template void symv(T,const SymmetricMatrixFCM<T>&,const Vector<T>&,T,Vector<T>&);
 
+MATRIX23_BLAS_INSTANTIATE(float)
+MATRIX23_BLAS_INSTANTIATE(double)
+MATRIX23_BLAS_INSTANTIATE(std::complex<float>)
+MATRIX23_BLAS_INSTANTIATE(std::complex<double>)
+MATRIX23_BLAS_INSTANTIATE_REAL(float)
+MATRIX23_BLAS_INSTANTIATE_REAL(double)
 
-} //namespace matrix23
\ No newline at end of file
+} //namespace matrix23
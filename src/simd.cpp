@@ -0,0 +1,278 @@
+// File: simd.cpp  AVX-512, AVX2 and scalar kernels behind simd.hpp
+
+#include "matrix23/simd.hpp"
+#include <atomic>
+#include <cstring>
+#include <algorithm>
+
+// The kernel helpers pass vectors by value, but are always inlined, so the ABI note is moot.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+namespace matrix23::simd {
+
+//
+//  The vector kernels are written once with GCC/clang vector extensions and force inlined into
+//  the target("...") wrappers below, so each wrapper gets code for its own register width.
+//  Complex data is handled as interleaved (re,im) pairs of reals.
+//
+namespace {
+
+template <class T, size_t Bytes> struct vec;
+template <> struct vec<double,64> {typedef double type __attribute__((vector_size(64)));};
+template <> struct vec<double,32> {typedef double type __attribute__((vector_size(32)));};
+template <> struct vec<float ,64> {typedef float  type __attribute__((vector_size(64)));};
+template <> struct vec<float ,32> {typedef float  type __attribute__((vector_size(32)));};
+
+template <class V, class T> [[gnu::always_inline]] inline V load(const T* p) {V v; std::memcpy(&v,p,sizeof(V)); return v;}
+template <class V, class T> [[gnu::always_inline]] inline void store(T* p, const V& v) {std::memcpy(p,&v,sizeof(V));}
+// Swap the re,im in each pair.
+template <class V> [[gnu::always_inline]] inline V swap_pairs(const V& v)
+{
+    using M=decltype(v<v); //Integer vector with the same lane layout.
+    constexpr size_t W=sizeof(V)/sizeof(v[0]);
+    M m;
+    for (size_t l=0;l<W;l++) m[l]=l^1;
+    return __builtin_shuffle(v,m);
+}
+template <class V, class T> [[gnu::always_inline]] inline T hsum(const V& v)
+{
+    T r(0);
+    for (size_t l=0;l<sizeof(V)/sizeof(T);l++) r+=v[l];
+    return r;
+}
+
+// Four independent accumulators to hide the FMA latency.
+template <size_t Bytes, class T> [[gnu::always_inline]] inline T dot_kernel(const T* a, const T* b, size_t n)
+{
+    using V=typename vec<T,Bytes>::type;
+    constexpr size_t W=Bytes/sizeof(T);
+    V s0{},s1{},s2{},s3{};
+    size_t i=0;
+    for (;i+4*W<=n;i+=4*W)
+    {
+        s0+=load<V>(a+i    )*load<V>(b+i    );
+        s1+=load<V>(a+i+  W)*load<V>(b+i+  W);
+        s2+=load<V>(a+i+2*W)*load<V>(b+i+2*W);
+        s3+=load<V>(a+i+3*W)*load<V>(b+i+3*W);
+    }
+    for (;i+W<=n;i+=W) s0+=load<V>(a+i)*load<V>(b+i);
+    T r=hsum<V,T>((s0+s1)+(s2+s3));
+    for (;i<n;i++) r+=a[i]*b[i];
+    return r;
+}
+//  For complex a,b stored as reals: re += a*b on even lanes minus odd lanes,
+//  im += a*swap(b) summed over all lanes.
+template <size_t Bytes, class T> [[gnu::always_inline]] inline std::complex<T> cdot_kernel(const T* a, const T* b, size_t n)
+{
+    using V=typename vec<T,Bytes>::type;
+    constexpr size_t W=Bytes/sizeof(T);
+    size_t n2=2*n;
+    V r0{},r1{},i0{},i1{};
+    size_t i=0;
+    for (;i+2*W<=n2;i+=2*W)
+    {
+        V a0=load<V>(a+i),a1=load<V>(a+i+W),b0=load<V>(b+i),b1=load<V>(b+i+W);
+        r0+=a0*b0;
+        r1+=a1*b1;
+        i0+=a0*swap_pairs(b0);
+        i1+=a1*swap_pairs(b1);
+    }
+    for (;i+W<=n2;i+=W)
+    {
+        V a0=load<V>(a+i),b0=load<V>(b+i);
+        r0+=a0*b0;
+        i0+=a0*swap_pairs(b0);
+    }
+    V rs=r0+r1, is=i0+i1;
+    T re(0),im=hsum<V,T>(is);
+    for (size_t l=0;l<W;l+=2) re+=rs[l]-rs[l+1];
+    for (;i<n2;i+=2)
+    {
+        re+=a[i]*b[i]-a[i+1]*b[i+1];
+        im+=a[i]*b[i+1]+a[i+1]*b[i];
+    }
+    return {re,im};
+}
+template <size_t Bytes, class T> [[gnu::always_inline]] inline void axpy_kernel(T alpha, const T* x, T* y, size_t n)
+{
+    using V=typename vec<T,Bytes>::type;
+    constexpr size_t W=Bytes/sizeof(T);
+    V va=V{}+alpha;
+    size_t i=0;
+    for (;i+2*W<=n;i+=2*W)
+    {
+        store(y+i  ,load<V>(y+i  )+va*load<V>(x+i  ));
+        store(y+i+W,load<V>(y+i+W)+va*load<V>(x+i+W));
+    }
+    for (;i+W<=n;i+=W) store(y+i,load<V>(y+i)+va*load<V>(x+i));
+    for (;i<n;i++) y[i]+=alpha*x[i];
+}
+//  y += re(alpha)*x + (-im(alpha),im(alpha))*swap(x)
+template <size_t Bytes, class T> [[gnu::always_inline]] inline void caxpy_kernel(std::complex<T> alpha, const T* x, T* y, size_t n)
+{
+    using V=typename vec<T,Bytes>::type;
+    constexpr size_t W=Bytes/sizeof(T);
+    size_t n2=2*n;
+    V vr=V{}+alpha.real(), vi;
+    for (size_t l=0;l<W;l++) vi[l]= l%2 ? alpha.imag() : -alpha.imag();
+    size_t i=0;
+    for (;i+W<=n2;i+=W)
+    {
+        V x0=load<V>(x+i);
+        store(y+i,load<V>(y+i)+vr*x0+vi*swap_pairs(x0));
+    }
+    for (;i<n2;i+=2)
+    {
+        y[i  ]+=alpha.real()*x[i  ]-alpha.imag()*x[i+1];
+        y[i+1]+=alpha.real()*x[i+1]+alpha.imag()*x[i  ];
+    }
+}
+
+//
+//  Plain C++ fallbacks.  Complex arithmetic is spelled out to avoid the NaN/Inf recovery
+//  code in std::complex operator*.
+//
+template <class T> T dot_scalar(const T* a, const T* b, size_t n)
+{
+    T s0(0),s1(0),s2(0),s3(0);
+    size_t i=0;
+    for (;i+4<=n;i+=4)
+    {
+        s0+=a[i  ]*b[i  ];
+        s1+=a[i+1]*b[i+1];
+        s2+=a[i+2]*b[i+2];
+        s3+=a[i+3]*b[i+3];
+    }
+    for (;i<n;i++) s0+=a[i]*b[i];
+    return (s0+s1)+(s2+s3);
+}
+template <class T> std::complex<T> cdot_scalar(const T* a, const T* b, size_t n)
+{
+    T re(0),im(0);
+    for (size_t i=0;i<2*n;i+=2)
+    {
+        re+=a[i]*b[i]-a[i+1]*b[i+1];
+        im+=a[i]*b[i+1]+a[i+1]*b[i];
+    }
+    return {re,im};
+}
+template <class T> void axpy_scalar(T alpha, const T* x, T* y, size_t n)
+{
+    for (size_t i=0;i<n;i++) y[i]+=alpha*x[i];
+}
+template <class T> void caxpy_scalar(std::complex<T> alpha, const T* x, T* y, size_t n)
+{
+    for (size_t i=0;i<2*n;i+=2)
+    {
+        y[i  ]+=alpha.real()*x[i  ]-alpha.imag()*x[i+1];
+        y[i+1]+=alpha.real()*x[i+1]+alpha.imag()*x[i  ];
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MATRIX23_SIMD_X86
+[[gnu::target("avx512f")]] double dot512(const double* a, const double* b, size_t n) {return dot_kernel<64>(a,b,n);}
+[[gnu::target("avx512f")]] float  dot512(const float * a, const float * b, size_t n) {return dot_kernel<64>(a,b,n);}
+[[gnu::target("avx512f")]] std::complex<double> cdot512(const double* a, const double* b, size_t n) {return cdot_kernel<64>(a,b,n);}
+[[gnu::target("avx512f")]] std::complex<float > cdot512(const float * a, const float * b, size_t n) {return cdot_kernel<64>(a,b,n);}
+[[gnu::target("avx512f")]] void axpy512(double a, const double* x, double* y, size_t n) {axpy_kernel<64>(a,x,y,n);}
+[[gnu::target("avx512f")]] void axpy512(float  a, const float * x, float * y, size_t n) {axpy_kernel<64>(a,x,y,n);}
+[[gnu::target("avx512f")]] void caxpy512(std::complex<double> a, const double* x, double* y, size_t n) {caxpy_kernel<64>(a,x,y,n);}
+[[gnu::target("avx512f")]] void caxpy512(std::complex<float > a, const float * x, float * y, size_t n) {caxpy_kernel<64>(a,x,y,n);}
+
+[[gnu::target("avx2,fma")]] double dot256(const double* a, const double* b, size_t n) {return dot_kernel<32>(a,b,n);}
+[[gnu::target("avx2,fma")]] float  dot256(const float * a, const float * b, size_t n) {return dot_kernel<32>(a,b,n);}
+[[gnu::target("avx2,fma")]] std::complex<double> cdot256(const double* a, const double* b, size_t n) {return cdot_kernel<32>(a,b,n);}
+[[gnu::target("avx2,fma")]] std::complex<float > cdot256(const float * a, const float * b, size_t n) {return cdot_kernel<32>(a,b,n);}
+[[gnu::target("avx2,fma")]] void axpy256(double a, const double* x, double* y, size_t n) {axpy_kernel<32>(a,x,y,n);}
+[[gnu::target("avx2,fma")]] void axpy256(float  a, const float * x, float * y, size_t n) {axpy_kernel<32>(a,x,y,n);}
+[[gnu::target("avx2,fma")]] void caxpy256(std::complex<double> a, const double* x, double* y, size_t n) {caxpy_kernel<32>(a,x,y,n);}
+[[gnu::target("avx2,fma")]] void caxpy256(std::complex<float > a, const float * x, float * y, size_t n) {caxpy_kernel<32>(a,x,y,n);}
+#endif
+
+isa detect()
+{
+#ifdef MATRIX23_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return isa::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return isa::avx2;
+#endif
+    return isa::scalar;
+}
+std::atomic<isa>& current()
+{
+    static std::atomic<isa> c{supported()};
+    return c;
+}
+
+template <class T> T dispatch_dot(const T* a, const T* b, size_t n)
+{
+    switch (selected())
+    {
+#ifdef MATRIX23_SIMD_X86
+        case isa::avx512: return dot512(a,b,n);
+        case isa::avx2  : return dot256(a,b,n);
+#endif
+        default         : return dot_scalar(a,b,n);
+    }
+}
+template <class T> std::complex<T> dispatch_cdot(const std::complex<T>* ca, const std::complex<T>* cb, size_t n)
+{
+    // std::complex<T> is layout compatible with T[2].
+    const T* a=reinterpret_cast<const T*>(ca);
+    const T* b=reinterpret_cast<const T*>(cb);
+    switch (selected())
+    {
+#ifdef MATRIX23_SIMD_X86
+        case isa::avx512: return cdot512(a,b,n);
+        case isa::avx2  : return cdot256(a,b,n);
+#endif
+        default         : return cdot_scalar(a,b,n);
+    }
+}
+template <class T> void dispatch_axpy(T alpha, const T* x, T* y, size_t n)
+{
+    switch (selected())
+    {
+#ifdef MATRIX23_SIMD_X86
+        case isa::avx512: axpy512(alpha,x,y,n); return;
+        case isa::avx2  : axpy256(alpha,x,y,n); return;
+#endif
+        default         : axpy_scalar(alpha,x,y,n);
+    }
+}
+template <class T> void dispatch_caxpy(std::complex<T> alpha, const std::complex<T>* cx, std::complex<T>* cy, size_t n)
+{
+    const T* x=reinterpret_cast<const T*>(cx);
+    T* y=reinterpret_cast<T*>(cy);
+    switch (selected())
+    {
+#ifdef MATRIX23_SIMD_X86
+        case isa::avx512: caxpy512(alpha,x,y,n); return;
+        case isa::avx2  : caxpy256(alpha,x,y,n); return;
+#endif
+        default         : caxpy_scalar(alpha,x,y,n);
+    }
+}
+
+} //anonymous namespace
+
+isa supported()
+{
+    static const isa s=detect();
+    return s;
+}
+isa selected() {return current().load(std::memory_order_relaxed);}
+void select(isa i) {current().store(std::min(i,supported()));}
+
+float                dot(const float               * a, const float               * b, size_t n) {return dispatch_dot (a,b,n);}
+double               dot(const double              * a, const double              * b, size_t n) {return dispatch_dot (a,b,n);}
+std::complex<float > dot(const std::complex<float >* a, const std::complex<float >* b, size_t n) {return dispatch_cdot(a,b,n);}
+std::complex<double> dot(const std::complex<double>* a, const std::complex<double>* b, size_t n) {return dispatch_cdot(a,b,n);}
+
+void axpy(float                alpha, const float               * x, float               * y, size_t n) {dispatch_axpy (alpha,x,y,n);}
+void axpy(double               alpha, const double              * x, double              * y, size_t n) {dispatch_axpy (alpha,x,y,n);}
+void axpy(std::complex<float > alpha, const std::complex<float >* x, std::complex<float >* y, size_t n) {dispatch_caxpy(alpha,x,y,n);}
+void axpy(std::complex<double> alpha, const std::complex<double>* x, std::complex<double>* y, size_t n) {dispatch_caxpy(alpha,x,y,n);}
+
+} //namespace matrix23::simd
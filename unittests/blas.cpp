@@ -4,10 +4,12 @@
 #include <iostream>
 #include "matrix23/matrix.hpp"
 #include "matrix23/blas.hpp"
+#include "test_helpers.hpp"
 
 using std::cout;
 using std::endl;
 using matrix23::Vector;
+using matrix23::test::maxdiff;
 
 class BlasTests : public ::testing::Test
 {
@@ -142,44 +144,124 @@ TEST_F(BlasTests,ColMajor_gemm)
         EXPECT_EQ(A*B,blasmm(A,B));
     }
 }
-// TEST_F(BlasTests,RowMajor_gemm)
-// {
-//     using M=matrix23::FullMatrixRM<double>;
-//     // size_t nr=30,k=35,nc=40;
-//     // size_t nr=1,k=4,nc=2;
-//     {
-//         // M A(nr,k)
-//         // M B(k,nc)
-//         // M A({{1,2,3,4}});
-//         // M B({{4,1},{3,2},{2,3},{1,4}});
-//         // M A({{1,2,3,4},
-//         //      {4,3,2,1}});
-//         // M B({{4},
-//         //      {3},
-//         //      {2},
-//         //      {1}});
-//         M A({{1,2},
-//              {4,3}});
-//         M B({{2},
-//              {1}});
-//         A.print();
-//         B.print();
-//         M C(A.nr(),B.nc());
-//         matrix23::gemm(1.0,A,B,0.0,C);
-//         C.print();
-
-//         M C1=A*B;
-//         C1.print();
-//         // M delta=A*B-C;
-//         // EXPECT_EQ(A*B,C);
-//     }
-//     // {
-//     //     M A(nr,k,matrix23::one);
-//     //     M B(k,nc,matrix23::one);
-        
-//     //     EXPECT_EQ(A*B,blasmm(A,B));
-//     // }
-// }
+// Every RM/CM combination of A, B and C, checked against the column major product.
+template <class Ma, class Mb, class Mc> void check_gemm(size_t nr, size_t k, size_t nc)
+{
+    using CM=matrix23::FullMatrixCM<double>;
+    CM A0(nr,k,matrix23::random), B0(k,nc,matrix23::random), C0(nr,nc,matrix23::random);
+    Ma A(A0);
+    Mb B(B0);
+    Mc C(C0);
+    CM AB(nr,nc);
+    matrix23::gemm(1.0,A0,B0,0.0,AB);
+    matrix23::gemm(2.0,A,B,0.5,C);
+    for (size_t i=0;i<nr;i++)
+        for (size_t j=0;j<nc;j++)
+            EXPECT_NEAR(C(i,j),2.0*AB(i,j)+0.5*C0(i,j),1e-13);
+}
+
+TEST_F(BlasTests,RowMajor_gemm)
+{
+    using CM=matrix23::FullMatrixCM<double>;
+    using RM=matrix23::FullMatrixRM<double>;
+    size_t nr=30,k=35,nc=40;
+    check_gemm<CM,CM,RM>(nr,k,nc);
+    check_gemm<CM,RM,CM>(nr,k,nc);
+    check_gemm<CM,RM,RM>(nr,k,nc);
+    check_gemm<RM,CM,CM>(nr,k,nc);
+    check_gemm<RM,CM,RM>(nr,k,nc);
+    check_gemm<RM,RM,CM>(nr,k,nc);
+    check_gemm<RM,RM,RM>(nr,k,nc);
+    check_gemm<RM,RM,RM>(1,4,2);
+    check_gemm<CM,CM,CM>(nr,0,nc); //Empty A and B, C=0.5*C.
+    check_gemm<RM,CM,RM>(nr,0,nc);
+    {
+        RM A(nr,k,matrix23::random);
+        RM B(k,nc,matrix23::random);
+        RM C=blasmm(A,B);
+        CM AB=CM(A)*CM(B);
+        for (size_t i=0;i<nr;i++)
+            for (size_t j=0;j<nc;j++)
+                EXPECT_NEAR(C(i,j),AB(i,j),1e-13);
+    }
+}
+
+// Padded leading dimensions are passed through as lda, ldb, ldc.
+TEST_F(BlasTests,Padded)
+{
+    using namespace matrix23;
+    using CM=FullMatrixCM<double>;
+    size_t nr=30,k=35,nc=40;
+    CM A0(nr,k,matrix23::random), B0(k,nc,matrix23::random);
+    CM A(FullPackerCM(nr,k,padded_ld<double>(nr)),zero), B(FullPackerCM(k,nc,padded_ld<double>(k)),zero);
+    CM C(FullPackerCM(nr,nc,padded_ld<double>(nr)),zero);
+    A=A0;
+    B=B0;
+    gemm(1.0,A,B,0.0,C);
+    CM AB=A0*B0;
+    for (size_t i=0;i<nr;i++)
+        for (size_t j=0;j<nc;j++)
+            EXPECT_NEAR(C(i,j),AB(i,j),1e-13);
+    SymmetricMatrixFCM<double> S(FullPackerCM(nr,nr,padded_ld<double>(nr)),zero);
+    syrk(1.0,A,0.0,S);
+    CM AAt=A0*~A0;
+    for (size_t i=0;i<nr;i++)
+        for (size_t j=0;j<nr;j++)
+            EXPECT_NEAR(S(i,j),AAt(i,j),1e-13);
+}
+
+TEST_F(BlasTests,SubMatrix)
+{
+    using namespace matrix23;
+    using CM=FullMatrixCM<double>;
+    using RM=FullMatrixRM<double>;
+    size_t n=60;
+    CM A(n,n,matrix23::random), C(n,n,zero);
+    RM B(n,n,matrix23::random);
+    iota_view r(5,25), k(10,40), c(30,57);
+    // C(r,c)=A(r,k)*B(k,c) straight on the parents' storage.
+    gemm(1.0,A.submatrix(r,k),B.submatrix(k,c),0.0,C.submatrix(r,c));
+    CM AB=CM(A.submatrix(r,k))*RM(B.submatrix(k,c));
+    const CM& cC=C;
+    for (size_t i=0;i<n;i++)
+        for (size_t j=0;j<n;j++)
+            if (r.front()<=i && i<=r.back() && c.front()<=j && j<=c.back())
+                EXPECT_NEAR(cC(i,j),AB(i-r.front(),j-c.front()),1e-13);
+            else
+                EXPECT_EQ(cC(i,j),0.0);
+    // Row major block.
+    Vector<double> x(k.size(),matrix23::random), y(r.size(),zero);
+    gemv(1.0,B.submatrix(r,k),x,0.0,y);
+    RM Bs(B.submatrix(r,k));
+    for (size_t i=0;i<r.size();i++)
+    {
+        double s=0.0;
+        for (size_t j=0;j<k.size();j++) s+=Bs(i,j)*x(j);
+        EXPECT_NEAR(y(i),s,1e-13);
+    }
+}
+
+TEST_F(BlasTests,Offload)
+{
+    using CM=matrix23::FullMatrixCM<double>;
+    using RM=matrix23::FullMatrixRM<double>;
+    size_t nr=70,k=50,nc=60;
+    CM A(nr,k,matrix23::random), B(k,nc,matrix23::random);
+    CM AB=A*B; //native engine
+    matrix23::set_blas_offload(40);
+    EXPECT_NE(matrix23::gemm_offload<double>::gemm,nullptr);
+    CM C=A*B;
+    RM D(nr,nc);
+    D=A*B;
+    matrix23::set_blas_offload(0);
+    EXPECT_EQ(matrix23::gemm_offload<double>::gemm,nullptr);
+    for (size_t i=0;i<nr;i++)
+        for (size_t j=0;j<nc;j++)
+        {
+            EXPECT_NEAR(C(i,j),AB(i,j),1e-13);
+            EXPECT_NEAR(D(i,j),AB(i,j),1e-13);
+        }
+}
 
 TEST_F(BlasTests,ColMajor_trmm)
 {
@@ -226,4 +308,68 @@ TEST_F(BlasTests,ColMajor_trmm)
         EXPECT_EQ(BA,B);
     }
    
-}
\ No newline at end of file
+}
+
+// Run the s/c/z flavours against the ranges/native results.
+template <class T> void check_blas_type(double eps)
+{
+    using namespace matrix23;
+    size_t nr=30,k=35,nc=40;
+    FullMatrixCM<T> A(nr,k,matrix23::random);
+    FullMatrixRM<T> Ar(A);
+    FullMatrixCM<T> B(k,nc,matrix23::random);
+    Vector<T> x(k,matrix23::random),xr(nr,matrix23::random);
+    EXPECT_LT(maxdiff(blasmv(A,x),Vector<T>(A*x)),k*eps);
+    EXPECT_LT(maxdiff(blasmv(Ar,x),Vector<T>(A*x)),k*eps);
+    EXPECT_LT(maxdiff(blasvm(xr,A),Vector<T>(xr*A)),nr*eps);
+    EXPECT_LT(maxdiff(blasmm(A,B),FullMatrixCM<T>(A*B)),k*eps);
+    EXPECT_LT(maxdiff(blasmm(Ar,B),FullMatrixCM<T>(A*B)),k*eps);
+
+    UpperTriangularMatrixCM<T> U(k,matrix23::random);
+    Vector<T> Ux=x;
+    tpmv(U,Ux);
+    EXPECT_LT(maxdiff(Ux,Vector<T>(U*x)),k*eps);
+    LowerTriangularMatrixRM<T> L(k,matrix23::random);
+    Vector<T> Lx=x;
+    tpmv(L,Lx);
+    EXPECT_LT(maxdiff(Lx,Vector<T>(L*x)),k*eps);
+
+    SBandMatrix<T> S(k,3,matrix23::random);
+    Vector<T> Sx(k);
+    gemv(S,x,Sx);
+    EXPECT_LT(maxdiff(Sx,Vector<T>(S*x)),k*eps);
+
+    UpperTriangularMatrixFCM<T> UF=UpperTriangularMatrixCM<T>(nr,matrix23::random);
+    FullMatrixCM<T> C(nr,nc,matrix23::random);
+    FullMatrixCM<T> UC=UF*C;
+    trmm(T(1),UF,C);
+    EXPECT_LT(maxdiff(C,UC),nr*eps);
+
+    SymmetricMatrixFCM<T> SF=SymmetricMatrixCM<T>(nr,matrix23::random);
+    FullMatrixCM<T> SB(nr,nc),BS(k,nr);
+    FullMatrixCM<T> Bs(nr,nc,matrix23::random),Bt(k,nr,matrix23::random);
+    symm(T(1),SF,Bs,T(0),SB);
+    EXPECT_LT(maxdiff(SB,FullMatrixCM<T>(SF*Bs)),nr*eps);
+    symm(T(1),Bt,SF,T(0),BS);
+    EXPECT_LT(maxdiff(BS,FullMatrixCM<T>(Bt*SF)),nr*eps);
+    SymmetricMatrixFCM<T> AAt(nr,nr);
+    syrk(T(1),A,T(0),AAt);
+    EXPECT_LT(maxdiff(AAt,FullMatrixCM<T>(A*~A)),k*eps);
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        SymmetricMatrixCM<T> SP(SF);
+        Vector<T> SPx(nr),SFx(nr);
+        gemv(SP,xr,SPx);
+        gemv(SF,xr,SFx);
+        EXPECT_LT(maxdiff(SPx,Vector<T>(SP*xr)),nr*eps);
+        EXPECT_LT(maxdiff(SFx,Vector<T>(SP*xr)),nr*eps);
+    }
+}
+
+TEST_F(BlasTests,Types)
+{
+    check_blas_type<float>(1e-6);
+    check_blas_type<double>(1e-15);
+    check_blas_type<std::complex<float >>(1e-6);
+    check_blas_type<std::complex<double>>(1e-15);
+}
@@ -0,0 +1,132 @@
+// File: unittests/gemm.cpp  Test the native cache blocked gemm engine.
+#include "gtest/gtest.h"
+#include <iostream>
+#include "matrix23/matrix.hpp"
+#include "matrix23/batched.hpp"
+#include "test_helpers.hpp"
+
+using std::cout;
+using std::endl;
+using matrix23::FullMatrixCM;
+using matrix23::FullMatrixRM;
+using matrix23::isMatrix;
+using matrix23::test::maxdiff;
+using matrix23::test::mymul;
+
+class NativeGemmTests : public ::testing::Test
+{
+public:
+    NativeGemmTests() = default;
+    ~NativeGemmTests() override = default;
+};
+
+TEST_F(NativeGemmTests, Sizes)
+{
+    // Include sizes that are not multiples of the register and cache blocks.
+    for (size_t n:{1,2,3,7,8,9,17,63,64,65,100,257,300})
+    {
+        FullMatrixCM<double> A(n,n+3,matrix23::random);
+        FullMatrixCM<double> B(n+3,n+1,matrix23::random);
+        FullMatrixCM<double> C=A*B;
+        EXPECT_LT(maxdiff(C,mymul(A,B)),(n+3)*1e-15) << "n=" << n;
+    }
+}
+TEST_F(NativeGemmTests, RowMajorDestination)
+{
+    size_t nr=67,k=301,nc=45;
+    FullMatrixCM<double> A(nr,k,matrix23::random);
+    FullMatrixCM<double> B(k,nc,matrix23::random);
+    FullMatrixRM<double> C=A*B;
+    EXPECT_LT(maxdiff(C,mymul(A,B)),k*1e-15);
+    FullMatrixRM<double> D(nr,nc);
+    D=A*B;
+    EXPECT_LT(maxdiff(D,mymul(A,B)),k*1e-15);
+}
+TEST_F(NativeGemmTests, AlphaBetaStrides)
+{
+    size_t m=37,k=29,n=23;
+    FullMatrixCM<double> A(m,k,matrix23::random);
+    FullMatrixRM<double> B(k,n,matrix23::random);
+    FullMatrixCM<double> C(m,n,matrix23::random);
+    FullMatrixCM<double> AB=mymul(A,B);
+    FullMatrixCM<double> C0=C;
+    // C = 2*A*B + 3*C with A column major and B row major.
+    matrix23::native::gemm(m,n,k,2.0,&*A.begin(),1,m,&*B.begin(),n,1,3.0,&*C.begin(),1,m);
+    EXPECT_LT(maxdiff(C,2*AB+3*C0),k*1e-14);
+    // Transposed operand through the strides: C = (A^T)^T*B
+    FullMatrixRM<double> At=~A;
+    matrix23::native::gemm(m,n,k,1.0,&*At.begin(),1,m,&*B.begin(),n,1,0.0,&*C.begin(),1,m);
+    EXPECT_LT(maxdiff(C,AB),k*1e-15);
+    // Degenerate k.
+    matrix23::native::gemm(m,n,size_t(0),1.0,&*A.begin(),1,m,&*B.begin(),n,1,0.0,&*C.begin(),1,m);
+    EXPECT_EQ(fnorm(C),0.0);
+}
+TEST_F(NativeGemmTests, Float)
+{
+    size_t m=33,k=70,n=19;
+    FullMatrixCM<float> A(m,k,matrix23::random);
+    FullMatrixCM<float> B(k,n,matrix23::random);
+    FullMatrixCM<float> C=A*B;
+    for (size_t i=0;i<m;i++)
+        for (size_t j=0;j<n;j++)
+        {
+            double t=0.0;
+            for (size_t p=0;p<k;p++) t+=double(A(i,p))*B(p,j);
+            EXPECT_NEAR(C(i,j),t,k*1e-6);
+        }
+}
+
+TEST_F(NativeGemmTests, Batched)
+{
+    using namespace matrix23;
+    // Enough matrices to go parallel, and a count that leaves the last compact group part full.
+    size_t m=8,k=12,n=5,count=2051;
+    std::vector<FullMatrixCM<double>> A,B,C;
+    std::vector<FullMatrixRM<double>> Br;
+    std::vector<Vector<double>> x,y;
+    for (size_t b=0;b<count;b++)
+    {
+        A.emplace_back(m,k,matrix23::random);
+        B.emplace_back(k,n,matrix23::random);
+        Br.emplace_back(B.back());
+        C.emplace_back(m,n,matrix23::random);
+        x.emplace_back(k,matrix23::random);
+        y.emplace_back(m,zero);
+    }
+    std::vector<FullMatrixCM<double>> C0=C;
+    gemm_batched(2.0,A,B,0.5,C);
+    for (size_t b=0;b<count;b+=97)
+        EXPECT_LT(maxdiff(C[b],FullMatrixCM<double>(2.0*mymul(A[b],B[b])+0.5*C0[b])),1e-14) << b;
+    gemm_batched(1.0,A,Br,0.0,C); //Row major B.
+    for (size_t b=0;b<count;b+=97)
+        EXPECT_LT(maxdiff(C[b],mymul(A[b],B[b])),1e-14) << b;
+    gemv_batched(1.0,A,x,0.0,y);
+    for (size_t b=0;b<count;b+=97)
+    {
+        Vector<double> Ax=A[b]*x[b];
+        for (size_t i=0;i<m;i++) EXPECT_NEAR(y[b](i),Ax(i),1e-14);
+    }
+    // Compact interleaved layout.
+    MatrixBatch<double> Ab(A),Bb(B),Cb(m,n,count,zero);
+    EXPECT_EQ(maxdiff(Ab.get(5),A[5]),0.0);
+    gemm(1.0,Ab,Bb,0.0,Cb);
+    for (size_t b=0;b<count;b+=97)
+        EXPECT_LT(maxdiff(Cb.get(b),mymul(A[b],B[b])),1e-14) << b;
+    EXPECT_LT(maxdiff(Cb.get(count-1),mymul(A[count-1],B[count-1])),1e-14);
+    MatrixBatch<double> xb(k,1,count),yb(m,1,count,zero);
+    for (size_t b=0;b<count;b++)
+        for (size_t i=0;i<k;i++) xb(b,i,0)=x[b](i);
+    gemv(1.0,Ab,xb,0.0,yb);
+    for (size_t b=0;b<count;b+=97)
+        for (size_t i=0;i<m;i++) EXPECT_NEAR(yb(b,i,0),y[b](i),1e-14);
+    // k==0, the products are empty and C is only scaled.
+    std::vector<FullMatrixCM<double>> A0(3,FullMatrixCM<double>(m,0)),B0(3,FullMatrixCM<double>(0,n)),C1(C.begin(),C.begin()+3);
+    std::vector<Vector<double>> x0(3,Vector<double>(0)),y1(y.begin(),y.begin()+3);
+    gemm_batched(1.0,A0,B0,0.5,C1);
+    gemv_batched(1.0,A0,x0,0.5,y1);
+    for (size_t b=0;b<3;b++)
+    {
+        EXPECT_EQ(maxdiff(C1[b],FullMatrixCM<double>(0.5*C[b])),0.0) << b;
+        for (size_t i=0;i<m;i++) EXPECT_EQ(y1[b](i),0.5*y[b](i));
+    }
+}
@@ -475,4 +475,44 @@ TEST_F(MatrixTests, UpperTriangularRowajor4x3_FullPaking)
     EXPECT_EQ(A.col(1),(il{2,5}));
     EXPECT_EQ(A.col(2),(il{3,6,9}));
    
-}
\ No newline at end of file
+}
+
+// Contiguous slices should come out as spans, fixed strides as strided spans.
+template <class V> constexpr bool is_span_view=std::ranges::contiguous_range<const V>;
+template <class V> constexpr bool is_strided_view=std::ranges::random_access_range<const V> && !is_span_view<V>;
+TEST_F(MatrixTests, SliceViews)
+{
+    using namespace matrix23;
+    FullMatrixCM<double> A(3,4,matrix23::random);
+    static_assert(is_span_view   <decltype(A.col(0))>);
+    static_assert(is_strided_view<decltype(A.row(0))>);
+    FullMatrixRM<double> B(3,4,matrix23::random);
+    static_assert(is_span_view   <decltype(B.row(0))>);
+    static_assert(is_strided_view<decltype(B.col(0))>);
+    UpperTriangularMatrixCM<double> U(4,matrix23::random);
+    static_assert(is_span_view<decltype(U.col(0))>);
+    LowerTriangularMatrixRM<double> L(4,matrix23::random);
+    static_assert(is_span_view<decltype(L.row(0))>);
+    SBandMatrix<double> S(6,2,matrix23::random);
+    static_assert(is_span_view   <decltype(S.col(0))>);
+    static_assert(is_strided_view<decltype(S.row(0))>);
+    // Off diagonal elements come from the other triangle, so no direct slices.
+    SymmetricMatrixCM<double> Sym(4,matrix23::random);
+    static_assert(!is_span_view<decltype(Sym.col(0))>);
+
+    for (size_t i=0;i<6;i++)
+    {
+        auto si=S.row(i);
+        auto ij=si.begin();
+        for (size_t j:si.indices()) EXPECT_EQ(*ij++,S(i,j));
+        auto sj=S.col(i);
+        auto ki=sj.begin();
+        for (size_t k:sj.indices()) EXPECT_EQ(*ki++,S(k,i));
+    }
+    for (size_t i=0;i<3;i++)
+    {
+        auto ai=A.row(i);
+        auto ij=ai.begin();
+        for (size_t j:ai.indices()) EXPECT_EQ(*ij++,A(i,j));
+    }
+}
@@ -3,10 +3,15 @@
 #include <iostream>
 #include <ranges>
 #include "matrix23/matrix.hpp"
+#include "matrix23/lu.hpp"
+#include "matrix23/cholesky.hpp"
+#include "test_helpers.hpp"
 
 using std::cout;
 using std::endl;
 using matrix23::Vector;
+using matrix23::test::maxdiff;
+using matrix23::test::mymul;
 
 class MatrixAlgebraTests : public ::testing::Test
 {
@@ -765,3 +770,977 @@ TEST_F(MatrixAlgebraTests, MatrixTranspose)
     }
 }
 
+TEST_F(MatrixAlgebraTests, MatrixMultiplyDiagonalKernels)
+{
+    using matrix23::DiagonalMatrix;
+    using matrix23::FullMatrixCM;
+    using matrix23::FullMatrixRM;
+    // Includes rectangular diagonals and sizes big enough to be split across threads.
+    for (auto [nr,nc]:{std::pair<size_t,size_t>{3,4},{4,3},{5,5},{70,90},{90,70}})
+    {
+        DiagonalMatrix<double> D1(nr,nc,matrix23::random),D2(nc,nr,matrix23::random);
+        FullMatrixCM<double> A(nc,nr+2,matrix23::random),B(nr+2,nr,matrix23::random);
+        FullMatrixRM<double> Ar(nc,nr+2,matrix23::random),Br(nr+2,nr,matrix23::random);
+
+        DiagonalMatrix<double> DD=D1*D2;
+        EXPECT_EQ(maxdiff(DD,mymul(D1,D2)),0.0) << nr << "x" << nc;
+        FullMatrixCM<double> DA=D1*A;
+        EXPECT_EQ(maxdiff(DA,mymul(D1,A)),0.0) << nr << "x" << nc;
+        FullMatrixRM<double> DAr=D1*Ar;
+        EXPECT_EQ(maxdiff(DAr,mymul(D1,Ar)),0.0) << nr << "x" << nc;
+        FullMatrixCM<double> BD=B*D1;
+        EXPECT_EQ(maxdiff(BD,mymul(B,D1)),0.0) << nr << "x" << nc;
+        FullMatrixRM<double> BrD=Br*D1;
+        EXPECT_EQ(maxdiff(BrD,mymul(Br,D1)),0.0) << nr << "x" << nc;
+        // Destination layout differs from the full operand.
+        FullMatrixRM<double> DA_rm=D1*A;
+        EXPECT_EQ(maxdiff(DA_rm,DA),0.0) << nr << "x" << nc;
+        FullMatrixCM<double> BrD_cm=Br*D1;
+        EXPECT_EQ(maxdiff(BrD_cm,BrD),0.0) << nr << "x" << nc;
+        // Element access on the lazy views.
+        auto v=D1*A;
+        EXPECT_EQ(maxdiff(v,DA),0.0) << nr << "x" << nc;
+        auto w=D1*D2;
+        EXPECT_EQ(maxdiff(w,DD),0.0) << nr << "x" << nc;
+    }
+}
+TEST_F(MatrixAlgebraTests, MatrixMultiplyBandKernels)
+{
+    using matrix23::SBandMatrix;
+    using matrix23::FullMatrixCM;
+    using matrix23::FullMatrixRM;
+    // Includes bands wider than the matrix and sizes big enough to be split across threads.
+    for (size_t n:{1,2,6,40,200})
+        for (auto [ka,kb]:{std::pair<size_t,size_t>{0,0},{1,2},{3,0},{5,5}})
+        {
+            SBandMatrix<double> A(n,ka,matrix23::random),B(n,kb,matrix23::random);
+            FullMatrixCM<double> F(n,n+3,matrix23::random),G(n+3,n,matrix23::random);
+            FullMatrixRM<double> Fr(n,n+3,matrix23::random),Gr(n+3,n,matrix23::random);
+            double eps=1e-14*(2*ka+1);
+
+            SBandMatrix<double> AB=A*B;
+            EXPECT_EQ(AB.bandwidth(),ka+kb);
+            EXPECT_LT(maxdiff(AB,mymul(A,B)),eps) << n << " " << ka << " " << kb;
+            auto v=A*B;
+            EXPECT_LT(maxdiff(v,AB),eps) << n << " " << ka << " " << kb;
+
+            FullMatrixCM<double> AF=A*F;
+            EXPECT_LT(maxdiff(AF,mymul(A,F)),eps) << n << " " << ka;
+            FullMatrixRM<double> AFr=A*Fr;
+            EXPECT_LT(maxdiff(AFr,mymul(A,Fr)),eps) << n << " " << ka;
+            FullMatrixCM<double> GB=G*B;
+            EXPECT_LT(maxdiff(GB,mymul(G,B)),eps) << n << " " << kb;
+            FullMatrixRM<double> GrB=Gr*B;
+            EXPECT_LT(maxdiff(GrB,mymul(Gr,B)),eps) << n << " " << kb;
+            // Destination layout differs from the full operand.
+            FullMatrixRM<double> AF_rm=A*F;
+            EXPECT_LT(maxdiff(AF_rm,AF),eps) << n << " " << ka;
+            FullMatrixCM<double> GrB_cm=Gr*B;
+            EXPECT_LT(maxdiff(GrB_cm,GrB),eps) << n << " " << kb;
+            auto w=Gr*B;
+            EXPECT_LT(maxdiff(w,GrB),eps) << n << " " << kb;
+        }
+    // Long thin bands, split over columns.  Compare with the element by element view.
+    SBandMatrix<double> A(3000,5,matrix23::random),B(3000,4,matrix23::random);
+    SBandMatrix<double> AB=A*B;
+    auto v=A*B;
+    double d=0.0;
+    for (size_t j=0;j<AB.nc();j++)
+        for (size_t i:AB.shaper().nonzero_row_indexes(j))
+            d=std::max(d,std::fabs(AB(i,j)-v(i,j)));
+    EXPECT_LT(d,1e-13);
+}
+template <class V> constexpr bool is_triangular_view=false;
+template <class... A> constexpr bool is_triangular_view<matrix23::TriangularMatrixProductView<A...>> =true;
+
+TEST_F(MatrixAlgebraTests, MatrixMultiplyTriangularKernels)
+{
+    using namespace matrix23;
+    auto check=[&](const auto& A, const auto& B)
+    {
+        static_assert(is_triangular_view<decltype(A*B)>);
+        using S=decltype((A*B).shaper()); //Full storage destinations with the product shape.
+        Matrix<double,FullPackerCM,S> C=A*B;
+        Matrix<double,FullPackerRM,S> Cr=A*B;
+        auto R=mymul(A,B);
+        double eps=1e-15*(A.nc()+1);
+        EXPECT_LT(maxdiff(C,R),eps) << A.nr() << "x" << A.nc() << "*" << B.nc();
+        EXPECT_LT(maxdiff(Cr,R),eps) << A.nr() << "x" << A.nc() << "*" << B.nc();
+        return R;
+    };
+    // Sizes below, at and well above the tile size, and big enough to be split across threads.
+    for (size_t n:{1,5,37,300})
+    {
+        UpperTriangularMatrixCM<double> U(n,n,matrix23::random);
+        LowerTriangularMatrixCM<double> L(n,n,matrix23::random);
+        UpperTriangularMatrixRM<double> Ur(n,n,matrix23::random);
+        LowerTriangularMatrixRM<double> Lr(n,n,matrix23::random);
+        UpperTriangularMatrixFCM<double> Uf(n,n,matrix23::random);
+        LowerTriangularMatrixFCM<double> Lf(n,n,matrix23::random);
+        FullMatrixCM<double> F(n,n+3,matrix23::random),G(n+2,n,matrix23::random);
+        FullMatrixRM<double> Fr(n,n+1,matrix23::random);
+
+        auto UU=check(U,U);
+        check(L,L);
+        check(U,L);
+        check(L,U);
+        check(Ur,Ur);
+        check(Lr,Ur);
+        check(Uf,Uf);
+        check(Lf,Uf);
+        check(U,F);
+        check(G,L);
+        check(Uf,F);
+        check(Lr,Fr);
+        check(U,Lf);
+        // Full operands are read in place, padding and all.
+        FullMatrixCM<double> Fp(FullPackerCM(n,n+3,n+5),matrix23::random);
+        check(U,Fp);
+        FullMatrixRM<double> Fpr(FullPackerRM(n+2,n,n+4),matrix23::random);
+        check(Fpr,Lr);
+        // Packed and full packed triangular destinations.
+        UpperTriangularMatrixCM<double> Up=U*U;
+        EXPECT_LT(maxdiff(Up,UU),1e-15*(n+1));
+        UpperTriangularMatrixRM<double> Upr=Ur*Ur;
+        EXPECT_LT(maxdiff(Upr,mymul(Ur,Ur)),1e-15*(n+1));
+        UpperTriangularMatrixFCM<double> Ufp=Uf*Uf;
+        EXPECT_LT(maxdiff(Ufp,mymul(Uf,Uf)),1e-15*(n+1));
+        // Element access on the lazy view.
+        auto v=U*U;
+        EXPECT_LT(maxdiff(v,UU),1e-15*(n+1));
+    }
+}
+
+TEST_F(MatrixAlgebraTests, MatrixMultiplySymmetricKernels)
+{
+    using namespace matrix23;
+    // Sizes below, at and well above the column block, and big enough to be split across threads.
+    for (size_t n:{1,5,37,300})
+    {
+        double eps=1e-15*(n+50);
+        SymmetricMatrixCM<double> S(n,matrix23::random);
+        Vector<double> v(n,matrix23::random);
+        FullMatrixCM<double> Sf(S);
+        Vector<double> Sv=S*v, vS=v*S;
+        Vector<double> Sfv=Sf*v;
+        for (size_t i=0;i<n;i++)
+        {
+            EXPECT_NEAR(Sv(i),Sfv(i),eps);
+            EXPECT_NEAR(vS(i),Sfv(i),eps);
+        }
+
+        FullMatrixCM<double> A(n,50,matrix23::random),B(n,50,matrix23::random);
+        auto AAt=mymul(A,Transpose(A));
+        FullMatrixCM<double> C=A*~A;
+        FullMatrixRM<double> Cr=A*~A;
+        SymmetricMatrixCM<double> Cs=A*~A;
+        EXPECT_LT(maxdiff(C,AAt),eps);
+        EXPECT_LT(maxdiff(Cr,AAt),eps);
+        EXPECT_LT(maxdiff(Cs,AAt),eps);
+        FullMatrixCM<double> AtA=~A*A;
+        EXPECT_LT(maxdiff(AtA,mymul(Transpose(A),A)),eps);
+        // Different data, plain gemm.
+        FullMatrixCM<double> ABt=A*~B;
+        EXPECT_LT(maxdiff(ABt,mymul(A,Transpose(B))),eps);
+        FullMatrixCM<double> AtB=~A*B;
+        EXPECT_LT(maxdiff(AtB,mymul(Transpose(A),B)),eps);
+        // Element access on the lazy view.
+        auto At=~A;
+        auto lv=A*At;
+        EXPECT_LT(maxdiff(lv,AAt),eps);
+
+        // S*F and F*S through native::symm, either storage order, and updated in place.
+        double eps_s=1e-14*(n+50); //n terms.
+        FullMatrixRM<double> Ar(A);
+        FullMatrixCM<double> G(50,n,matrix23::random);
+        FullMatrixRM<double> Gr(G);
+        auto SA=mymul(Sf,A), GS=mymul(G,Sf);
+        FullMatrixCM<double> SAc=S*A, GSc=G*S;
+        FullMatrixRM<double> SAr=S*Ar, GSr=Gr*S;
+        EXPECT_LT(maxdiff(SAc,SA),eps_s);
+        EXPECT_LT(maxdiff(SAr,SA),eps_s);
+        EXPECT_LT(maxdiff(GSc,GS),eps_s);
+        EXPECT_LT(maxdiff(GSr,GS),eps_s);
+        SAc+=S*A;
+        GSr-=Gr*S;
+        EXPECT_LT(maxdiff(SAc,2.0*SA),2*eps_s);
+        EXPECT_LT(maxdiff(GSr,0.0*GS),eps_s);
+        auto lsa=S*A;
+        auto lgs=G*S;
+        EXPECT_LT(maxdiff(lsa,SA),eps_s);
+        EXPECT_LT(maxdiff(lgs,GS),eps_s);
+    }
+}
+
+TEST_F(MatrixAlgebraTests, MatrixAssignInPlace)
+{
+    using namespace matrix23;
+    size_t n=70;
+    double eps=1e-13;
+    FullMatrixCM<double> A(n,n,matrix23::random),B(n,n,matrix23::random);
+    FullMatrixCM<double> AB(A*B);
+    // Empty destination takes the dimensions of the product.
+    FullMatrixCM<double> C;
+    C=A*B;
+    ASSERT_EQ(C.nr(),n);
+    ASSERT_EQ(C.nc(),n);
+    EXPECT_LT(maxdiff(C,AB),eps);
+    // Same dimensions, same storage.
+    const double* c0=&*C.begin();
+    C=B*A;
+    EXPECT_EQ(&*C.begin(),c0);
+    C.noalias()=A*B;
+    EXPECT_EQ(&*C.begin(),c0);
+    EXPECT_LT(maxdiff(C,AB),eps);
+    // Accumulate with gemm beta=1.
+    C+=A*B;
+    EXPECT_EQ(&*C.begin(),c0);
+    EXPECT_LT(maxdiff(C,2.0*AB),eps);
+    C-=A*B;
+    EXPECT_LT(maxdiff(C,AB),eps);
+    C.noalias()-=A*B;
+    EXPECT_LT(maxdiff(C,FullMatrixCM<double>(n,n,zero)),eps);
+    C.update(2.0,A*B,0.0);
+    EXPECT_LT(maxdiff(C,2.0*AB),eps);
+    // Aliased right hand sides go through a temporary.
+    C=B;
+    C=A*C;
+    EXPECT_LT(maxdiff(C,AB),eps);
+    C=A;
+    C=C*B;
+    EXPECT_LT(maxdiff(C,AB),eps);
+    C=B;
+    C+=A*C;
+    FullMatrixCM<double> Ref=AB+B;
+    EXPECT_LT(maxdiff(C,Ref),eps);
+    C=A;
+    C=C+B;
+    Ref=A+B;
+    EXPECT_LT(maxdiff(C,Ref),eps);
+    // Same type -= subtracts.
+    C-=B;
+    EXPECT_LT(maxdiff(C,A),eps);
+    // Band products take the product bandwidth.
+    SBandMatrix<double> S1(n,2,matrix23::random),S2(n,3,matrix23::random),S;
+    S=S1*S2;
+    EXPECT_EQ(S.bandwidth(),5);
+    EXPECT_LT(maxdiff(S,S1*S2),eps);
+    // Vectors resize.
+    Vector<double> v(n,matrix23::random),w;
+    w=A*v;
+    ASSERT_EQ(w.size(),n);
+}
+
+TEST_F(MatrixAlgebraTests, MatrixPaddedStorage)
+{
+    using namespace matrix23;
+    size_t n=37,ld=padded_ld<double>(n);
+    EXPECT_EQ(ld,40);
+    FullMatrixCM<double> A(n,n,matrix23::random),B(n,n,matrix23::random);
+    FullMatrixCM<double> Ap(FullPackerCM(n,n,ld),zero),Bp(FullPackerCM(n,n,ld),zero);
+    Ap=A; //Keeps the padding.
+    Bp=B;
+    EXPECT_EQ(Ap.packer().ld(),ld);
+    EXPECT_EQ(Ap.size(),ld*n);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&*Ap.begin())%cache_line,0);
+    EXPECT_EQ(maxdiff(Ap,A),0.0);
+    // Slices step over the padding.
+    EXPECT_EQ(Ap.row(3),A.row(3));
+    EXPECT_EQ(Ap.col(5),A.col(5));
+    // Products read and write through ld.
+    FullMatrixCM<double> AB=A*B;
+    FullMatrixCM<double> Cp(FullPackerCM(n,n,ld),zero);
+    Cp=Ap*Bp;
+    EXPECT_EQ(Cp.packer().ld(),ld);
+    EXPECT_LT(maxdiff(Cp,AB),1e-13);
+    FullMatrixCM<double> C=Ap*Bp;
+    EXPECT_LT(maxdiff(C,AB),1e-13);
+    FullMatrixCM<double> AAt=A*~A;
+    Cp=Ap*~Ap;
+    EXPECT_LT(maxdiff(Cp,AAt),1e-13);
+    C=~Ap*B;
+    EXPECT_LT(maxdiff(C,FullMatrixCM<double>(~A*B)),1e-13);
+    FullMatrixRM<double> Rp(FullPackerRM(n,n,ld),zero);
+    Rp=Ap*B;
+    EXPECT_LT(maxdiff(Rp,AB),1e-13);
+    Cp=Rp*DiagonalMatrix<double>(n,n,one);
+    EXPECT_LT(maxdiff(Cp,AB),1e-13);
+    // Matrix+=Matrix walks the two storages in step, unless one is padded and the other isn't.
+    using M=Matrix<double,FullPackerCM,FullShaper>;
+    FullMatrixCM<double> S(A);
+    Ap=A;
+    static_cast<M&>(Ap)+=static_cast<const M&>(B);
+    static_cast<M&>(S )+=static_cast<const M&>(Bp);
+    FullMatrixCM<double> ApB=A+B;
+    EXPECT_EQ(maxdiff(Ap,ApB),0.0);
+    EXPECT_EQ(maxdiff(S,ApB),0.0);
+    static_cast<M&>(Ap)-=static_cast<const M&>(B);
+    static_cast<M&>(S )-=static_cast<const M&>(Bp);
+    EXPECT_EQ(maxdiff(Ap,A),0.0);
+    EXPECT_EQ(maxdiff(S,A),0.0);
+    EXPECT_EQ(Ap.packer().ld(),ld);
+    // Moving in an unpadded temporary keeps the padding too.
+    Cp=FullMatrixCM<double>(AB);
+    EXPECT_EQ(Cp.packer().ld(),ld);
+    EXPECT_EQ(maxdiff(Cp,AB),0.0);
+    // Fills leave the padding zero, so logically equal padded matrices have equal storage.
+    FullMatrixCM<double> Xp(FullPackerCM(n,n,ld),matrix23::random),Yp(FullPackerCM(n,n,ld),zero);
+    const double* x=&*Xp.begin();
+    for (size_t j=0;j<n;j++)
+        for (size_t i=n;i<ld;i++) EXPECT_EQ(x[i+j*ld],0.0);
+    Yp=FullMatrixCM<double>(Xp);
+    EXPECT_TRUE(same_data(Xp,Yp));
+}
+
+// Counts what reaches new/delete.
+class counting_resource : public std::pmr::memory_resource
+{
+public:
+    size_t allocations=0, live=0;
+private:
+    void* do_allocate(size_t bytes, size_t align) override
+    {
+        allocations++; live++;
+        return std::pmr::new_delete_resource()->allocate(bytes,align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override
+    {
+        live--;
+        std::pmr::new_delete_resource()->deallocate(p,bytes,align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override {return this==&r;}
+};
+
+TEST_F(MatrixAlgebraTests, ArenaTemporaries)
+{
+    using namespace matrix23;
+    counting_resource heap;
+    auto* outer=set_current_resource(&heap);
+    size_t n=20;
+    FullMatrixCM<double> A(n,n,matrix23::random),B(n,n,matrix23::random),C(n,n,zero);
+    Vector<double> v(n,matrix23::random);
+    FullMatrixCM<double> AB=A*B;
+    auto step=[&]()
+    {
+        for (int i=0;i<100;i++)
+        {
+            FullMatrixCM<double> T1=A*B;
+            FullMatrixRM<double> R(T1);
+            C=T1+A*B; //C keeps its heap storage, the temporaries don't.
+            Vector<double> Av=A*v;
+            EXPECT_EQ(Av.size(),n);
+        }
+    };
+    size_t before=heap.allocations;
+    step();
+    EXPECT_GE(heap.allocations-before,300);
+    before=heap.allocations;
+    {
+        scoped_arena arena;
+        EXPECT_EQ(current_resource(),arena.resource());
+        step();
+        EXPECT_LE(heap.allocations-before,3); //Just the arena's blocks.
+    }
+    EXPECT_EQ(current_resource(),&heap);
+    EXPECT_EQ(heap.live,size_t(3+1+1)); //A,B,C,v,AB
+    for (size_t i=0;i<n;i++)
+        for (size_t j=0;j<n;j++)
+            EXPECT_NEAR(C(i,j),2*AB(i,j),1e-13);
+    // Assigning arena storage to an outside matrix copies into the outside storage.
+    {
+        FullMatrixCM<double> Ac(n,n);
+        {
+            scoped_arena arena;
+            FullMatrixCM<double> Tmp=A*B;
+            Ac=Tmp;
+        }
+        EXPECT_EQ(Ac,AB);
+    }
+    set_current_resource(outer);
+}
+
+TEST_F(MatrixAlgebraTests, MatrixVectorInPlace)
+{
+    using namespace matrix23;
+    size_t n=40;
+    FullMatrixCM<double> A(n,n,matrix23::random);
+    FullMatrixRM<double> Ar(A);
+    Vector<double> x(n,matrix23::random),y0(n,matrix23::random),y(n),Ax(n),xA(n);
+    for (size_t i=0;i<n;i++)
+    {
+        double ax=0,xa=0;
+        for (size_t j=0;j<n;j++) {ax+=A(i,j)*x(j); xa+=x(j)*A(j,i);}
+        Ax(i)=ax;
+        xA(i)=xa;
+    }
+    auto near=[&](const Vector<double>& a, auto&& b)
+    {
+        for (size_t i=0;i<n;i++) EXPECT_NEAR(a(i),b(i),1e-13);
+    };
+    // x is read where it is, y is written where it is.
+    counting_resource heap;
+    auto* outer=set_current_resource(&heap);
+    y=A*x;
+    near(y,Ax);
+    y=Ar*x;
+    near(y,Ax);
+    y=x*A;
+    near(y,xA);
+    y=x*Ar;
+    near(y,xA);
+    y=y0;
+    y.update(2.0,A*x,-1.0);
+    near(y,[&](size_t i) {return 2*Ax(i)-y0(i);});
+    y=y0;
+    y+=A*x;
+    near(y,[&](size_t i) {return y0(i)+Ax(i);});
+    y-=x*Ar;
+    near(y,[&](size_t i) {return y0(i)+Ax(i)-xA(i);});
+    y=A*x+y0;
+    near(y,[&](size_t i) {return Ax(i)+y0(i);});
+    EXPECT_EQ(heap.allocations,0);
+    // y=A*y reads all of y while it is written, so it goes through a temporary.
+    y=x;
+    y=A*y;
+    near(y,Ax);
+    y=x;
+    y=2.0*(y*A);
+    near(y,[&](size_t i) {return 2*xA(i);});
+    y=x;
+    y+=A*y;
+    near(y,[&](size_t i) {return x(i)+Ax(i);});
+    EXPECT_EQ(heap.allocations,3);
+    set_current_resource(outer);
+}
+
+TEST_F(MatrixAlgebraTests, FixedSize)
+{
+    using namespace matrix23;
+    using F3=FixedMatrixCM<double,3>;
+    using F34=FixedMatrixCM<double,3,4>;
+    using V3=FixedVector<double,3>;
+    using V4=FixedVector<double,4>;
+    using FCM=FullMatrixCM<double>;
+    static_assert(isMatrix<F3>);
+    static_assert(sizeof(F3)<=9*sizeof(double)+2*sizeof(void*)); //Just the data and the symmetry's references.
+    F3 A(matrix23::random);
+    F34 B(matrix23::random);
+    FCM Af(A),Bf(B);
+    // Unrolled kernels.
+    F34 AB=A*B;
+    EXPECT_LT(maxdiff(AB,FCM(Af*Bf)),1e-15);
+    V4 x(4,matrix23::random);
+    V3 Bx=B*x;
+    Vector<double> Bfx=Bf*Vector<double>(x);
+    for (size_t i=0;i<3;i++) EXPECT_NEAR(Bx(i),Bfx(i),1e-15);
+    V3 y(3,matrix23::random);
+    V4 yB=y*B;
+    Vector<double> yBf=Vector<double>(y)*Bf;
+    for (size_t j=0;j<4;j++) EXPECT_NEAR(yB(j),yBf(j),1e-15);
+    // Everything else goes through the generic views.
+    F3 S=A+A*2.0;
+    EXPECT_LT(maxdiff(S,FCM(Af*3.0)),1e-15);
+    FixedMatrixCM<double,4,3> Bt=~B;
+    EXPECT_EQ(maxdiff(Bt,~Bf),0.0);
+    F3 BBt=B*~B;
+    EXPECT_LT(maxdiff(BBt,FCM(Bf*~Bf)),1e-15);
+    F3 C;
+    C=Af*Af; //From a dynamic expression.
+    EXPECT_LT(maxdiff(C,FCM(Af*Af)),1e-15);
+    F3 I(unit);
+    EXPECT_LT(maxdiff(A*I,A),1e-15);
+    EXPECT_EQ(V3().size(),3);
+    // Mixed with dynamic sizes the product is dynamic, column major.
+    FCM D(4,2,matrix23::random);
+    FullMatrixRM<double> Dr(D);
+    static_assert(std::same_as<std::remove_cvref_t<decltype((B*D).packer())>,FullPackerCM>);
+    static_assert(std::same_as<std::remove_cvref_t<decltype((B*Dr).packer())>,FullPackerCM>);
+    static_assert(std::same_as<std::remove_cvref_t<decltype((~D*Bt).packer())>,FullPackerCM>);
+    static_assert(std::same_as<std::remove_cvref_t<decltype((B*D).shaper())>,FullShaper>);
+    static_assert(std::same_as<std::remove_cvref_t<decltype((~D*Bt).shaper())>,FullShaper>);
+    FCM BD=B*D, BDr=B*Dr, DBt=~D*Bt;
+    EXPECT_LT(maxdiff(BD,FCM(Bf*D)),1e-15);
+    EXPECT_LT(maxdiff(BDr,FCM(Bf*D)),1e-15);
+    EXPECT_LT(maxdiff(DBt,FCM(~D*~Bf)),1e-15);
+    EXPECT_LT(maxdiff(FCM(Af*I),Af),1e-15);
+}
+
+TEST_F(MatrixAlgebraTests, MatrixChain)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    using FRM=FullMatrixRM<double>;
+    double eps=1e-12;
+    FCM A(10,100,matrix23::random),B(100,5,matrix23::random),C(5,50,matrix23::random);
+    FCM AB=A*B, ABC=AB*C;
+    // Cheapest order is (A*B)*C whichever way it is written.
+    EXPECT_EQ((A*B*C).cost(),10*100*5+10*5*50);
+    EXPECT_EQ((A*(B*C)).cost(),10*100*5+10*5*50);
+    FCM R=A*B*C;
+    EXPECT_LT(maxdiff(R,ABC),eps);
+    R=A*(B*C);
+    EXPECT_LT(maxdiff(R,ABC),eps);
+    // Elements of an unassigned chain.
+    auto abc=A*B*C;
+    EXPECT_NEAR(abc(3,7),ABC(3,7),eps);
+    // Accumulate, and C appearing on both sides.
+    R+=A*B*C;
+    EXPECT_LT(maxdiff(R,2.0*ABC),eps);
+    FCM S(50,50,matrix23::random),S0(S),T(50,50,matrix23::random);
+    FCM TST=T*S; TST=TST*T;
+    S=T*S*T;
+    EXPECT_LT(maxdiff(S,TST),eps);
+    // Diagonal and band factors are cheap, D*SB*F*D costs (2k+1) per element of F.
+    size_t n=60;
+    DiagonalMatrix<double> D(n,n,matrix23::random),E(n,n,matrix23::random);
+    SBandMatrix<double> SB(n,2,matrix23::random);
+    FCM F(n,n,matrix23::random);
+    FRM G(n,n,matrix23::random);
+    auto full=[](const auto& M)
+    {
+        FCM f(M.nr(),M.nc());
+        for (size_t i=0;i<M.nr();i++)
+            for (size_t j=0;j<M.nc();j++)
+                f(i,j)=M(i,j);
+        return f;
+    };
+    FCM SBf=full(SB),Df=full(D);
+    FCM DSB=Df*SBf;
+    FCM DSBFE=DSB*F; DSBFE=DSBFE*E;
+    FCM X=D*SB*F*E;
+    EXPECT_LT(maxdiff(X,DSBFE),eps);
+    EXPECT_LT((D*SB*F*E).cost(),2.0*n*n*5);
+    FCM FG=F*FCM(G);
+    X=F*G*E*D;
+    FCM FGED=FG*E; FGED=FGED*D;
+    EXPECT_LT(maxdiff(X,FGED),eps);
+    // Chains of diagonals and bands keep their packing.
+    DiagonalMatrix<double> DED=D*E*D;
+    for (size_t i=0;i<n;i++) EXPECT_NEAR(DED(i,i),D(i,i)*E(i,i)*D(i,i),eps);
+    SBandMatrix<double> B5=SB*SB*D*SB;
+    EXPECT_EQ(B5.bandwidth(),6);
+    FCM B5f=SBf*SBf; B5f=B5f*Df; B5f=B5f*SBf;
+    EXPECT_LT(maxdiff(B5,B5f),eps);
+}
+
+TEST_F(MatrixAlgebraTests, NestedExpressionCache)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    double eps=1e-12;
+    size_t n=40;
+    FCM A(n,n,matrix23::random),B(n,n,matrix23::random),C(n,n,matrix23::random),D(n,n,matrix23::random);
+    FCM AB=A*B, ABC=AB+C, R0=ABC*D;
+    // A*B+C is costly, the product caches its rows.
+    static_assert(costly_elements<decltype(A*B+C)>);
+    FCM R=(A*B+C)*D;
+    EXPECT_LT(maxdiff(R,R0),eps);
+    R=D*(A*B+C);
+    EXPECT_LT(maxdiff(R,FCM(D*ABC)),eps);
+    // Budgets of a few lines, and none at all.
+    for (size_t bytes:{3*n*sizeof(double),size_t(0)})
+    {
+        size_t old=set_cache_budget(bytes);
+        R=(A*B+C)*D;
+        EXPECT_LT(maxdiff(R,R0),eps);
+        set_cache_budget(old);
+    }
+    // By hand.
+    auto ab=cached(A*B);
+    EXPECT_LT(maxdiff(ab,AB),eps);
+    EXPECT_LT(maxdiff(ab,AB),eps); //Second pass from the cache.
+    // Triangular products nest through the cache too.
+    UpperTriangularMatrixCM<double> U(n,n,matrix23::random);
+    FCM Uf(n,n);
+    Uf=U;
+    FCM UUU(n,n),UUUf=Uf*Uf;
+    UUUf=UUUf*Uf;
+    UUU=U*U*U;
+    EXPECT_LT(maxdiff(UUU,UUUf),eps);
+    // Zeros below the diagonal come from the shaper, no row is filled for them.
+    auto uu=cached(U*U);
+    for (size_t i=1;i<n;i++) EXPECT_EQ(uu(i,0),0.0);
+    EXPECT_LT(maxdiff(uu,FCM(Uf*Uf)),eps);
+    // Lines filled inside an arena still come from where the view was made.
+    auto ab2=cached(A*B);
+    {
+        scoped_arena arena;
+        EXPECT_LT(maxdiff(ab2,AB),eps);
+    }
+    EXPECT_LT(maxdiff(ab2,AB),eps);
+}
+
+TEST_F(MatrixAlgebraTests, FusedElementwise)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    // Reference, element by element.
+    auto expr=[](const auto& A, const auto& B, const auto& C)
+    {
+        FCM R(A.nr(),A.nc());
+        for (size_t i=0;i<A.nr();i++)
+            for (size_t j=0;j<A.nc();j++)
+                R(i,j)=2*A(i,j)+B(i,j)-C(i,j)/3;
+        return R;
+    };
+    double eps=1e-14;
+    size_t n=37,ld=padded_ld<double>(n);
+    {
+        FCM A(n,n,matrix23::random),B(n,n,matrix23::random),C(n,n,matrix23::random);
+        FCM R=2.0*A+B-C/3.0;
+        EXPECT_TRUE((2.0*A+B-C/3.0).stored_like(R));
+        EXPECT_LT(maxdiff(R,expr(A,B,C)),eps);
+        R+=A-B; //load with beta=1
+        FCM R0=expr(A,B,C);
+        for (size_t j=0;j<n;j++)
+            for (size_t i=0;i<n;i++)
+                R0(i,j)+=A(i,j)-B(i,j);
+        EXPECT_LT(maxdiff(R,R0),eps);
+        // A padded operand doesn't line up, falls back to element access.
+        FCM Ap(FullPackerCM(n,n,ld),zero);
+        Ap=A;
+        EXPECT_FALSE((Ap+B).stored_like(R));
+        R=2.0*Ap+B-C/3.0;
+        EXPECT_LT(maxdiff(R,expr(A,B,C)),eps);
+        // Mixed packers too.
+        FullMatrixRM<double> Br(n,n);
+        Br=B;
+        R=2.0*A+Br-C/3.0;
+        EXPECT_LT(maxdiff(R,expr(A,B,C)),eps);
+        // In place goes through a temporary.
+        R=A;
+        R=2.0*R+B-C/3.0;
+        EXPECT_LT(maxdiff(R,expr(A,B,C)),eps);
+    }
+    {
+        UpperTriangularMatrixCM<double> A(n,n,matrix23::random),B(n,n,matrix23::random),C(n,n,matrix23::random);
+        UpperTriangularMatrixCM<double> R=2.0*A+B-C/3.0;
+        EXPECT_TRUE((A+B).stored_like(R));
+        EXPECT_LT(maxdiff(R,expr(A,B,C)),eps);
+    }
+    {
+        SBandMatrix<double> A(n,3,matrix23::random),B(n,3,matrix23::random),C(n,3,matrix23::random),W(n,2,zero);
+        SBandMatrix<double> R=2.0*A+B-C/3.0;
+        EXPECT_EQ(R.bandwidth(),3); //Sums don't widen the band.
+        EXPECT_TRUE((A+B).stored_like(R));
+        EXPECT_FALSE((A+B).stored_like(W)); //Different bandwidth.
+        EXPECT_LT(maxdiff(R,expr(A,B,C)),eps);
+    }
+    {
+        SymmetricMatrixCM<double> A(n,matrix23::random),B(n,matrix23::random),C(n,matrix23::random);
+        SymmetricMatrixCM<double> R=2.0*A+B-C/3.0;
+        EXPECT_LT(maxdiff(R,expr(A,B,C)),eps);
+        // Same packer, different symmetry, not fused.
+        UpperTriangularMatrixCM<double> U(n,n,matrix23::random);
+        EXPECT_FALSE((A+U).stored_like(R));
+    }
+}
+
+TEST_F(MatrixAlgebraTests, StoredOrderLoad)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    size_t n=50;
+    // Bands of different width don't fuse, the load walks the stored band only.
+    SBandMatrix<double> A(n,2,matrix23::random),B(n,4,matrix23::random);
+    SBandMatrix<double> S=A+B;
+    EXPECT_EQ(S.bandwidth(),4);
+    const auto& cA=A;
+    const auto& cB=B;
+    const auto& cS=S;
+    for (size_t i=0;i<n;i++)
+        for (size_t j=0;j<n;j++)
+            EXPECT_EQ(cS(i,j),cA(i,j)+cB(i,j));
+    S+=B; //beta=1 load
+    S-=B;
+    EXPECT_LT(maxdiff(S,A+B),1e-15);
+    // Scalar ops and += leave the padding alone.
+    size_t ld=padded_ld<double>(n-3);
+    FCM P(FullPackerCM(n-3,n,ld),zero), Q(n-3,n,matrix23::random);
+    P+=2.0;
+    P*=3.0;
+    P+=Q; //Different ld, goes through update().
+    P-=Q;
+    for (size_t j=0;j<n;j++)
+        for (size_t i=n-3;i<ld;i++)
+            EXPECT_EQ(*(P.begin()+i+j*ld),0.0);
+    EXPECT_LT(maxdiff(P,FCM(n-3,n,value,6.0)),1e-15);
+    // Symmetric loads only the upper triangle.
+    SymmetricMatrixCM<double> Sy(n,matrix23::random);
+    SymmetricMatrixCM<double> Sy2=Sy*2.0;
+    EXPECT_LT(maxdiff(Sy2,FCM(Sy)*2.0),1e-15);
+}
+
+TEST_F(MatrixAlgebraTests, TransposeKernels)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    using FRM=FullMatrixRM<double>;
+    auto transposed=[](const auto& A, const auto& B)
+    {
+        for (size_t i=0;i<A.nr();i++)
+            for (size_t j=0;j<A.nc();j++)
+                if (A(i,j)!=B(j,i)) return false;
+        return true;
+    };
+    for (size_t n:{size_t(1),size_t(7),size_t(37),size_t(300)})
+    {
+        size_t m=n+5;
+        FCM A(m,n,matrix23::random);
+        FRM B(m,n,matrix23::random);
+        EXPECT_TRUE(transposed(FCM(~A),A));
+        EXPECT_TRUE(transposed(FRM(~A),A));
+        EXPECT_TRUE(transposed(FCM(~B),B));
+        // Padded destination, the padding is left alone.
+        size_t ld=padded_ld<double>(n)+8;
+        FCM P(FullPackerCM(n,m,ld),zero);
+        P=~A;
+        EXPECT_TRUE(transposed(P,A));
+        for (size_t j=0;j<m;j++)
+            for (size_t i=n;i<ld;i++)
+                EXPECT_EQ(*(P.begin()+i+j*ld),0.0);
+        // CM <-> RM.
+        FRM R(A);
+        FCM C(R);
+        EXPECT_EQ(R,A);
+        EXPECT_EQ(C,A);
+        // In place.
+        FCM S(n,n,matrix23::random), S0(S);
+        transpose_in_place(S);
+        EXPECT_TRUE(transposed(S,S0));
+        FRM SR(S0);
+        transpose_in_place(SR);
+        EXPECT_TRUE(transposed(SR,S0));
+    }
+    // Packed triangular, ~U of CM upper is RM lower in the same memory order.
+    size_t n=40;
+    UpperTriangularMatrixCM<double> U(n,n,matrix23::random);
+    LowerTriangularMatrixRM<double> L(n,n);
+    LowerTriangularMatrixCM<double> Lc(n,n);
+    EXPECT_TRUE((~U).stored_like(L));
+    EXPECT_FALSE((~U).stored_like(Lc));
+    L=~U;
+    Lc=~U;
+    EXPECT_TRUE(std::equal(L.begin(),L.end(),U.begin()));
+    EXPECT_TRUE(transposed(L,U));
+    EXPECT_TRUE(transposed(Lc,U));
+    UpperTriangularMatrixRM<double> Ur=~L;
+    EXPECT_TRUE(transposed(Ur,L));
+}
+
+TEST_F(MatrixAlgebraTests, SubMatrix)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    using FRM=FullMatrixRM<double>;
+    size_t n=20;
+    FCM A(n,n,matrix23::random), A0(A);
+    FRM R(n,n,matrix23::random);
+    iota_view r(3,7), c(1,10);
+    auto S=A.submatrix(r,c);
+    static_assert(isMatrix<decltype(S)>);
+    EXPECT_EQ(S.nr(),4);
+    EXPECT_EQ(S.nc(),9);
+    for (size_t i=0;i<S.nr();i++)
+        for (size_t j=0;j<S.nc();j++)
+            EXPECT_EQ(S(i,j),A0(i+3,j+1));
+    // Copies out, rows and cols.
+    FCM E(S);
+    FRM F(S);
+    EXPECT_EQ(E,S);
+    EXPECT_EQ(F,S);
+    EXPECT_EQ(S.row(2),E.row(2));
+    EXPECT_EQ(S.col(4),E.col(4));
+    // Writes go to A, nothing else changes.
+    FRM B(4,9,matrix23::random);
+    S=B;
+    S+=B;
+    S(0,0)=-1.0;
+    const FCM& cA=A;
+    for (size_t i=0;i<n;i++)
+        for (size_t j=0;j<n;j++)
+            if (i>=3 && i<7 && j>=1 && j<10)
+                EXPECT_EQ(cA(i,j), i==3 && j==1 ? -1.0 : 2.0*B(i-3,j-1));
+            else
+                EXPECT_EQ(cA(i,j),A0(i,j));
+    // Products into a block, and blocks as operands.
+    auto P=R.submatrix(iota_view(0,4),iota_view(0,6));
+    auto Q=A0.submatrix(iota_view(2,8),iota_view(11,20));
+    S=P*Q;
+    FCM PQ=FCM(P)*FCM(Q);
+    EXPECT_LT(fnorm(FCM(S)-PQ),1e-13);
+    // A block assigned from an overlapping block of the same matrix goes through a temporary.
+    A=A0;
+    auto T=A.submatrix(iota_view(0,10),iota_view(0,10));
+    T=A.submatrix(iota_view(1,11),iota_view(1,11));
+    for (size_t i=0;i<10;i++)
+        for (size_t j=0;j<10;j++)
+            EXPECT_EQ(cA(i,j),A0(i+1,j+1));
+    // Views of views, const views, ~S.
+    const FCM& cA0=A0;
+    auto V=cA0.submatrix(iota_view(2,18),iota_view(2,18)).submatrix(iota_view(1,3),iota_view(4,5));
+    EXPECT_EQ(V(1,0),A0(4,6));
+    FRM St=~Q;
+    for (size_t i=0;i<Q.nr();i++)
+        for (size_t j=0;j<Q.nc();j++)
+            EXPECT_EQ(St(j,i),Q(i,j));
+}
+
+TEST_F(MatrixAlgebraTests, SubMatrixProducts)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    using FRM=FullMatrixRM<double>;
+    size_t n=30, m=12, k=9;
+    FCM A(n,n,matrix23::random), X(m,k,matrix23::random), Y(k,m,matrix23::random), Z(m,k,matrix23::random);
+    FRM R(n,n,matrix23::random);
+    SymmetricMatrixCM<double> Sy(m,matrix23::random);
+    UpperTriangularMatrixFCM<double> U(m,m,matrix23::random);
+    FCM XY=mymul(X,Y), XZt=mymul(X,Transpose(Z)), SyXZt=mymul(FCM(Sy),XZt), UXY=mymul(U,XY);
+    iota_view r(5,5+m), c(7,7+m);
+    // Block (i0,j0) of B is blk, the rest is B0.
+    auto check=[&](const auto& B, const auto& B0, const auto& blk, size_t i0, size_t j0)
+    {
+        for (size_t i=0;i<n;i++)
+            for (size_t j=0;j<n;j++)
+                if (i>=i0 && i<i0+blk.nr() && j>=j0 && j<j0+blk.nc())
+                    EXPECT_NEAR(B(i,j),blk(i-i0,j-j0),1e-13);
+                else
+                    EXPECT_EQ(B(i,j),B0(i,j));
+    };
+    // Products go straight into the block, in either storage order, with alpha and beta.
+    auto into=[&](auto& B)
+    {
+        auto B0=B;
+        counting_resource heap;
+        auto* outer=set_current_resource(&heap);
+        auto S=B.submatrix(r,c);
+        S=X*Y;
+        S+=X*~Z;
+        S-=Sy*XZt;
+        set_current_resource(outer);
+        EXPECT_EQ(heap.allocations,0);
+        check(B,B0,XY+XZt-SyXZt,5,7);
+    };
+    into(A);
+    into(R);
+    // Triangular operands, only the expanded triangle is allocated.
+    FCM A0(A);
+    auto S=A.submatrix(r,c);
+    S=U*XY;
+    check(A,A0,UXY,5,7);
+    S+=U*XY;
+    check(A,A0,2.0*UXY,5,7);
+    // A product reading the block it is assigned to still goes through a temporary.
+    A=A0;
+    FCM W(m,n,matrix23::random);
+    FCM WA=mymul(W,A0);
+    auto Rows=A.submatrix(r,iota_view(0,n));
+    Rows=W*A;
+    check(A,A0,WA,5,0);
+}
+
+TEST_F(MatrixAlgebraTests, LUSolve)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    // P*L*U, with the swaps undone in reverse order.
+    auto reassembled=[](const LU<double>& lu)
+    {
+        const FCM& F=lu.factors();
+        size_t m=F.nr(), n=F.nc(), k=std::min(m,n);
+        FCM L(m,k,zero), U(k,n,zero);
+        for (size_t i=0;i<m;i++)
+            for (size_t j=0;j<k;j++) L(i,j)= i==j ? 1.0 : i>j ? F(i,j) : 0.0;
+        for (size_t i=0;i<k;i++)
+            for (size_t j=i;j<n;j++) U(i,j)=F(i,j);
+        FCM A=L*U;
+        for (size_t i=k;i-->0;)
+            if (size_t p=lu.pivots()[i]; p!=i)
+                for (size_t j=0;j<n;j++) std::swap(A(i,j),A(p,j));
+        return A;
+    };
+    for (size_t n:{size_t(1),size_t(5),size_t(17),size_t(100),size_t(300)})
+    {
+        FCM A(n,n,matrix23::random);
+        LU<double> lu(A);
+        EXPECT_FALSE(lu.singular());
+        EXPECT_LT(fnorm(reassembled(lu)-A),n*1e-14);
+        Vector<double> b(n,matrix23::random);
+        Vector<double> x=lu.solve(b);
+        Vector<double> r=A*x-b;
+        // Residuals are bounded relative to |A||x|, and a random A can be poorly conditioned.
+        EXPECT_LT(sqrt(r*r),n*1e-12*std::max(1.0,sqrt(x*x)));
+        FCM B(n,7,matrix23::random);
+        FCM X=solve(A,B);
+        EXPECT_LT(fnorm(A*X-B),n*1e-12*std::max(1.0,fnorm(X)));
+        // Rectangular, both ways.
+        FCM T(n+9,n,matrix23::random), W(n,n+9,matrix23::random);
+        EXPECT_LT(fnorm(reassembled(LU<double>(T))-T),n*1e-14);
+        EXPECT_LT(fnorm(reassembled(LU<double>(W))-W),n*1e-14);
+    }
+    // Padded ld.
+    size_t n=70;
+    FCM A(FullPackerCM(n,n,padded_ld<double>(n)+8),matrix23::random);
+    LU<double> lu(A);
+    EXPECT_EQ(lu.factors().packer().ld(),padded_ld<double>(n)+8);
+    EXPECT_LT(fnorm(reassembled(lu)-A),n*1e-14);
+    // Determinant of a permuted diagonal.
+    FCM D(3,3,zero);
+    D(0,1)=2.0;  D(1,0)=3.0;  D(2,2)=4.0;
+    EXPECT_NEAR(LU<double>(D).determinant(),-24.0,1e-14);
+    // Singular, the zero column is reported.
+    FCM S(n,n,matrix23::random);
+    for (size_t i=0;i<n;i++) S(i,40)=0.0;
+    LU<double> ls(S);
+    EXPECT_TRUE(ls.singular());
+    EXPECT_EQ(ls.info(),41);
+    EXPECT_EQ(ls.determinant(),0.0);
+}
+
+TEST_F(MatrixAlgebraTests, CholeskySolve)
+{
+    using namespace matrix23;
+    using FCM=FullMatrixCM<double>;
+    // Diagonally dominant, so positive definite.
+    auto spd=[](size_t n)
+    {
+        SymmetricMatrixCM<double> A(n,matrix23::random);
+        for (size_t i=0;i<n;i++) A(i,i)+=n;
+        return A;
+    };
+    for (size_t n:{size_t(1),size_t(5),size_t(100),size_t(300),size_t(500)}) //Unblocked, one and several panels.
+    {
+        SymmetricMatrixCM<double> A=spd(n);
+        Cholesky<double> ch(A);
+        EXPECT_TRUE(ch.positive_definite());
+        const UpperTriangularMatrixCM<double>& U=ch.factor();
+        FCM UtU=~U*U;
+        EXPECT_LT(fnorm(UtU-FCM(A)),n*1e-13);
+        // Bit for bit the column by column (dpptrf) algorithm.
+        std::vector<double> AP(A.begin(),A.end());
+        EXPECT_EQ(native::pptf2(n,AP.data()),0);
+        EXPECT_TRUE(std::equal(AP.begin(),AP.end(),ch.factor().begin()));
+        Vector<double> b(n,matrix23::random);
+        Vector<double> x=ch.solve(b);
+        Vector<double> r=A*x-b;
+        EXPECT_LT(sqrt(r*r),n*1e-13);
+        FCM B(n,11,matrix23::random);
+        FCM X=solve(A,B);
+        EXPECT_LT(fnorm(FCM(A)*X-B),n*1e-13);
+    }
+    // In place on the upper triangle.
+    size_t n=70;
+    SymmetricMatrixCM<double> A=spd(n);
+    UpperTriangularMatrixCM<double> U(n,n);
+    std::copy(A.begin(),A.end(),U.begin());
+    EXPECT_EQ(cholesky_in_place(U),0);
+    EXPECT_TRUE(std::equal(U.begin(),U.end(),Cholesky<double>(A).factor().begin()));
+    // Not positive definite, the first bad column is reported.
+    A(40,40)=-1.0;
+    EXPECT_EQ(Cholesky<double>(A).info(),41);
+    SymmetricMatrixCM<double> A3=spd(300);
+    A3(150,150)=-1.0;
+    EXPECT_FALSE(Cholesky<double>(A3).positive_definite());
+    EXPECT_EQ(Cholesky<double>(A3).info(),151);
+}
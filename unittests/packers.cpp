@@ -2,6 +2,7 @@
 #include "gtest/gtest.h"
 #include <iostream>
 #include "matrix23/packer.hpp"
+#include "matrix23/aligned.hpp"
 
 using std::cout;
 using std::endl;
@@ -31,12 +32,15 @@ static_assert(isPacker<LowerTriangularPackerCM>);
 static_assert(isPacker<LowerTriangularPackerRM>);
 static_assert(isPacker<       DiagonalPacker  >);
 static_assert(isPacker<          SBandPacker  >);
+static_assert(isPacker<   FixedPackerCM<3,4>  >);
 
 static_assert(isShaper<           FullShaper>);
 static_assert(isShaper<UpperTriangularShaper>);
 static_assert(isShaper<LowerTriangularShaper>);
 static_assert(isShaper<       DiagonalShaper>);
 static_assert(isShaper<          SBandShaper>);
+static_assert(isShaper<    FixedShaper<3,4>>);
+static_assert(FixedPackerCM<3,4>().offset(2,3)==11); //constexpr offsets.
 
 
 TEST_F(PackerDeathTest, Full)
@@ -72,6 +76,33 @@ TEST_F(PackerDeathTest, Full)
     ASSERT_DEATH(fpcm.offset(0,4),"");
 #endif
 }
+TEST_F(PackerTests, FullPadded)
+{
+    size_t nr=3,nc=4;
+    FullPackerCM fpcm(nr,nc,8);
+    EXPECT_EQ(fpcm.ld(),8);
+    EXPECT_EQ(fpcm.stored_size(),32);
+    EXPECT_EQ(fpcm.offset(2,0),2);
+    EXPECT_EQ(fpcm.offset(0,1),8);
+    EXPECT_EQ(fpcm.offset(2,3),26);
+    EXPECT_EQ(fpcm.col_stride(),8);
+    FullPackerRM fprm(nr,nc,8);
+    EXPECT_EQ(fprm.stored_size(),24);
+    EXPECT_EQ(fprm.offset(0,3),3);
+    EXPECT_EQ(fprm.offset(1,0),8);
+    EXPECT_EQ(fprm.row_stride(),8);
+    // Resizing drops the padding.
+    fpcm.resize(5,2);
+    EXPECT_EQ(fpcm.ld(),5);
+    EXPECT_EQ(fpcm.stored_size(),10);
+    // Whole cache lines, off the 4K critical stride.
+    EXPECT_EQ(padded_ld<double>(3),8);
+    EXPECT_EQ(padded_ld<double>(8),8);
+    EXPECT_EQ(padded_ld<double>(9),16);
+    EXPECT_EQ(padded_ld<double>(512),520);
+    EXPECT_EQ(padded_ld<float>(1000),1008);
+    EXPECT_EQ(padded_ld<float>(1024),1040);
+}
 TEST_F(PackerDeathTest, UpperTriangular3x4)
 {
     GTEST_FLAG_SET(death_test_style, "fast"); //Assume single threads in test for now.
@@ -389,6 +420,50 @@ TEST_F(PackerDeathTest, SBandPacker6x6)
     
 }
 
+// for_each_stored visits every stored element once, at its offset, in storage order.
+template <isPacker P> void check_for_each_stored(const P& p)
+{
+    size_t count=0, stored=0, last=0;
+    p.for_each_stored([&](size_t i, size_t j, size_t o)
+    {
+        EXPECT_TRUE(p.is_stored(i,j));
+        EXPECT_EQ(o,p.offset(i,j));
+        EXPECT_LT(o,p.stored_size());
+        if (count>0) {EXPECT_GT(o,last);}
+        last=o;
+        count++;
+    });
+    for (size_t i=0;i<p.nr();i++)
+        for (size_t j=0;j<p.nc();j++)
+            if (p.is_stored(i,j)) stored++;
+    EXPECT_EQ(count,stored);
+}
+TEST_F(PackerTests, ForEachStored)
+{
+    for (auto [nr,nc] : {std::pair<size_t,size_t>(4,4),{3,5},{5,3},{1,4},{0,0}})
+    {
+        check_for_each_stored(FullPackerCM(nr,nc));
+        check_for_each_stored(FullPackerRM(nr,nc));
+        check_for_each_stored(FullPackerCM(nr,nc,nr+3)); //Skips the padding.
+        check_for_each_stored(FullPackerRM(nr,nc,nc+3));
+        check_for_each_stored(UpperTriangularPackerCM(nr,nc));
+        check_for_each_stored(UpperTriangularPackerRM(nr,nc));
+        check_for_each_stored(LowerTriangularPackerCM(nr,nc));
+        check_for_each_stored(LowerTriangularPackerRM(nr,nc));
+        check_for_each_stored(DiagonalPacker(nr,nc));
+    }
+    for (size_t k:{0,1,2,5,8})
+        check_for_each_stored(SBandPacker(6,k)); //Skips the corners.
+    check_for_each_stored(FixedPackerCM<3,2>());
+    // Columns right of an upper triangle are full, stored after it.
+    UpperTriangularPackerCM u(2,4);
+    EXPECT_EQ(u.offset(0,2),3);
+    EXPECT_EQ(u.offset(1,3),u.stored_size()-1);
+    LowerTriangularPackerRM l(4,2);
+    EXPECT_EQ(l.offset(2,0),3);
+    EXPECT_EQ(l.offset(3,1),l.stored_size()-1);
+}
+
 namespace std::ranges {
  
     bool operator==(const iota_view<size_t,size_t>& a, const iota_view<size_t,size_t>&b )
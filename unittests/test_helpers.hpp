@@ -0,0 +1,60 @@
+// File: unittests/test_helpers.hpp  Reference results shared by the unit tests.
+#pragma once
+
+#include "gtest/gtest.h"
+#include "matrix23/matrix.hpp"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace matrix23::test
+{
+
+// Largest |A(i,j)-B(i,j)|, from element access only.
+template <isMatrix Ma, isMatrix Mb> double maxdiff(const Ma& A, const Mb& B)
+{
+    EXPECT_EQ(A.nr(),B.nr());
+    EXPECT_EQ(A.nc(),B.nc());
+    double d=0.0;
+    for (size_t i=0;i<A.nr();i++)
+        for (size_t j=0;j<A.nc();j++)
+            d=std::max(d,double(std::abs(A(i,j)-B(i,j))));
+    return d;
+}
+template <class T> double maxdiff(const Vector<T>& a, const Vector<T>& b)
+{
+    EXPECT_EQ(a.size(),b.size());
+    double d=0.0;
+    for (size_t i=0;i<a.size();i++) d=std::max(d,double(std::abs(a(i)-b(i))));
+    return d;
+}
+
+// A(i,j) is inside the shape.  Full packed triangles hold junk outside it, everything else reads 0 there.
+template <isMatrix M> bool in_shape(const M& A, size_t i, size_t j)
+{
+    typedef std::remove_cvref_t<decltype(A.shaper())> S;
+    if constexpr (std::same_as<S,UpperTriangularShaper>)
+        return i<=j;
+    else if constexpr (std::same_as<S,LowerTriangularShaper>)
+        return i>=j;
+    else
+        return true;
+}
+
+// Reference product, a triple loop over element access inside the shapes.
+template <isMatrix Ma, isMatrix Mb> auto mymul(const Ma& A, const Mb& B)
+{
+    typedef std::remove_cvref_t<decltype(A(0,0)*B(0,0))> T;
+    FullMatrixCM<T> C(A.nr(),B.nc(),zero);
+    for (size_t i=0;i<A.nr();i++)
+        for (size_t j=0;j<B.nc();j++)
+        {
+            T t(0);
+            for (size_t l=0;l<A.nc();l++)
+                if (in_shape(A,i,l) && in_shape(B,l,j)) t+=A(i,l)*B(l,j);
+            C(i,j)=t;
+        }
+    return C;
+}
+
+} //namespace matrix23::test
@@ -0,0 +1,162 @@
+// File: unittests/threads.cpp  Test the work stealing thread pool and parallel matrix products.
+#include "gtest/gtest.h"
+#include <iostream>
+#include <atomic>
+#include <memory_resource>
+#include <thread>
+#include "matrix23/matrix.hpp"
+#include "matrix23/lu.hpp"
+#include "matrix23/cholesky.hpp"
+#include "test_helpers.hpp"
+
+using std::cout;
+using std::endl;
+using matrix23::FullMatrixCM;
+using matrix23::test::maxdiff;
+
+class ThreadTests : public ::testing::Test
+{
+public:
+    ThreadTests() : nthread0(matrix23::num_threads()) {matrix23::set_num_threads(4);}
+    ~ThreadTests() override {matrix23::set_num_threads(nthread0);}
+
+    size_t nthread0;
+};
+
+TEST_F(ThreadTests, ParallelFor)
+{
+    EXPECT_EQ(matrix23::num_threads(),4);
+    size_t n=1000;
+    std::vector<std::atomic<int>> hits(n);
+    matrix23::parallel_for(n,[&](size_t t){hits[t]++;});
+    for (auto& h:hits) EXPECT_EQ(h,1);
+    // Nested calls run serially inside the task.
+    std::atomic<size_t> count{0};
+    matrix23::parallel_for(10,[&](size_t){matrix23::parallel_for(10,[&](size_t){count++;});});
+    EXPECT_EQ(count,100);
+    // Exceptions get passed back to the caller.
+    EXPECT_THROW(matrix23::parallel_for(10,[](size_t t){if (t==7) throw std::runtime_error("task 7");}),std::runtime_error);
+    // And the pool is still usable afterwards.
+    count=0;
+    matrix23::parallel_for(10,[&](size_t){count++;});
+    EXPECT_EQ(count,10);
+}
+
+TEST_F(ThreadTests, FullProduct)
+{
+    size_t m=301,k=257,n=333;
+    FullMatrixCM<double> A(m,k,matrix23::random);
+    FullMatrixCM<double> B(k,n,matrix23::random);
+    FullMatrixCM<double> C=A*B; //Tiled parallel_gemm
+    EXPECT_LT(maxdiff(C,A*B),k*1e-15); //Compare with lazy op(i,j)
+    matrix23::FullMatrixRM<double> D=A*B;
+    EXPECT_LT(maxdiff(D,A*B),k*1e-15);
+}
+
+TEST_F(ThreadTests, GeneralProducts)
+{
+    size_t n=150;
+    {
+        matrix23::UpperTriangularMatrixCM<double> A(n,n,matrix23::random);
+        matrix23::UpperTriangularMatrixCM<double> B(n,n,matrix23::random);
+        matrix23::UpperTriangularMatrixCM<double> C=A*B;
+        EXPECT_LT(maxdiff(C,A*B),n*1e-15);
+    }
+    {
+        matrix23::LowerTriangularMatrixCM<double> A(n,n,matrix23::random);
+        matrix23::FullMatrixRM<double> B(n,n,matrix23::random);
+        matrix23::FullMatrixRM<double> C=A*B;
+        EXPECT_LT(maxdiff(C,A*B),n*1e-15);
+    }
+    {
+        matrix23::SBandMatrix<double> A(n,3,matrix23::random);
+        matrix23::SBandMatrix<double> B(n,2,matrix23::random);
+        matrix23::SBandMatrix<double> C=A*B;
+        EXPECT_EQ(C.bandwidth(),5);
+        EXPECT_LT(maxdiff(C,A*B),n*1e-15);
+    }
+    {
+        size_t m=300; //More than one symm tile, and split into column panels.
+        matrix23::SymmetricMatrixCM<double> S(m,matrix23::random);
+        FullMatrixCM<double> B(m,m,matrix23::random);
+        FullMatrixCM<double> C=S*B, D=B*S;
+        EXPECT_LT(maxdiff(C,S*B),m*1e-14);
+        EXPECT_LT(maxdiff(D,B*S),m*1e-14);
+    }
+}
+
+TEST_F(ThreadTests, SharedCache)
+{
+    size_t n=64;
+    FullMatrixCM<double> A(n,n,matrix23::random),B(n,n,matrix23::random);
+    FullMatrixCM<double> AB=A*B;
+    auto ab=matrix23::cached(A*B);
+    // Every task reads every row, so rows are filled and read from the cache by several threads at once.
+    std::atomic<size_t> bad{0};
+    matrix23::parallel_for(4*matrix23::num_threads(),[&](size_t t)
+    {
+        for (size_t i=0;i<n;i++)
+        {
+            size_t r=(i+t)%n;
+            for (size_t j=0;j<n;j++)
+                if (std::abs(ab(r,j)-AB(r,j))>n*1e-15) bad++;
+        }
+    });
+    EXPECT_EQ(bad,0);
+}
+
+// Counts allocations from threads other than the one that made it.  An arena may only be used by its own thread.
+class OwnerOnlyResource : public std::pmr::memory_resource
+{
+public:
+    std::atomic<size_t> foreign{0};
+private:
+    void* do_allocate(size_t n, size_t a) override
+    {
+        if (std::this_thread::get_id()!=owner) foreign++;
+        return std::pmr::new_delete_resource()->allocate(n,a);
+    }
+    void do_deallocate(void* p, size_t n, size_t a) override {std::pmr::new_delete_resource()->deallocate(p,n,a);}
+    bool do_is_equal(const std::pmr::memory_resource& r) const noexcept override {return this==&r;}
+    std::thread::id owner=std::this_thread::get_id();
+};
+
+TEST_F(ThreadTests, SharedCacheInArena)
+{
+    size_t n=128; //Big enough for the outer product to fill its cached rows from the pool.
+    FullMatrixCM<double> A(n,n,matrix23::random),B(n,n,matrix23::random),C(n,n,matrix23::random),D(n,n,matrix23::random);
+    FullMatrixCM<double> ABC=A*B+C, R0=ABC*D, R(n,n);
+    {
+        matrix23::scoped_arena arena;
+        R=(A*B+C)*D;
+    }
+    EXPECT_LT(maxdiff(R,R0),n*n*1e-13); //Elements are O(n^2).
+    // The cache is made on this thread, the pool fills its lines.
+    OwnerOnlyResource r;
+    auto* previous=matrix23::set_current_resource(&r);
+    R=(A*B+C)*D;
+    matrix23::set_current_resource(previous);
+    EXPECT_EQ(r.foreign,0);
+    EXPECT_LT(maxdiff(R,R0),n*n*1e-13); //Elements are O(n^2).
+}
+
+TEST_F(ThreadTests, ParallelLU)
+{
+    size_t n=600; //Big enough for threaded trailing updates and row swaps.
+    FullMatrixCM<double> A(n,n,matrix23::random), B(n,5,matrix23::random);
+    matrix23::LU<double> lu(A);
+    FullMatrixCM<double> X=lu.solve(B);
+    FullMatrixCM<double> R=A*X-B, Z(n,5,matrix23::zero);
+    EXPECT_LT(maxdiff(R,Z),n*1e-13*std::max(1.0,maxdiff(X,Z))); //Relative to |X|, a random A can be poorly conditioned.
+}
+
+TEST_F(ThreadTests, ParallelCholesky)
+{
+    size_t n=600; //Several panels, the panel dots and the pptrs right hand side columns run on the pool.
+    matrix23::SymmetricMatrixCM<double> A(n,matrix23::random);
+    for (size_t i=0;i<n;i++) A(i,i)+=n;
+    FullMatrixCM<double> B(n,20,matrix23::random);
+    FullMatrixCM<double> X=matrix23::Cholesky<double>(A).solve(B);
+    FullMatrixCM<double> R=FullMatrixCM<double>(A)*X-B;
+    EXPECT_LT(maxdiff(R,FullMatrixCM<double>(n,20,matrix23::zero)),n*1e-13);
+}
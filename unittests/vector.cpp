@@ -102,4 +102,56 @@ TEST_F(VectorTests, Intrsections)
     auto v2_intersection=v2 | std::views::drop(inter.drop2) | std::views::take(inter.indices.size());
     int dot=inner_product(v1_intersection,v2_intersection);
     EXPECT_EQ(dot, 4*4 + 5*5 + 6*6 + 7*7 + 8*8); 
-}
\ No newline at end of file
+}
+// Run the dot and axpy kernels on every instruction set this CPU supports, against a plain loop.
+// The sizes cover the unrolled body, the single vector loop and the scalar tail.
+template <class T> void check_simd_kernels(double eps)
+{
+    using namespace matrix23::simd;
+    isa best=supported();
+    for (isa i:{isa::scalar,isa::avx2,isa::avx512})
+    {
+        if (i>best) break;
+        select(i);
+        for (size_t n:{0,1,2,3,7,8,15,16,17,31,32,33,63,64,65,127,128,129,1000})
+        {
+            Vector<T> a(n,matrix23::random),b(n,matrix23::random),y(n,matrix23::random);
+            T d(0);
+            for (size_t k=0;k<n;k++) d+=a(k)*b(k);
+            EXPECT_NEAR(std::abs(dot(&*a.begin(),&*b.begin(),n)-d),0.0,n*eps) << "isa=" << int(i) << " n=" << n;
+            Vector<T> y0=y;
+            T alpha=OMLRandPos<T>();
+            axpy(alpha,&*a.begin(),&*y.begin(),n);
+            for (size_t k=0;k<n;k++) EXPECT_NEAR(std::abs(y(k)-(y0(k)+alpha*a(k))),0.0,eps) << "isa=" << int(i) << " n=" << n;
+        }
+    }
+    select(best);
+}
+TEST_F(VectorTests, SimdKernels)
+{
+    check_simd_kernels<double>(1e-14);
+    check_simd_kernels<float >(1e-5);
+    check_simd_kernels<std::complex<double>>(1e-14);
+    check_simd_kernels<std::complex<float >>(1e-5);
+}
+TEST_F(VectorTests, SimdOperators)
+{
+    size_t n=101;
+    Vector<double> a(n,matrix23::random),b(n,matrix23::random);
+    double d=0.0;
+    for (size_t k=0;k<n;k++) d+=a(k)*b(k);
+    EXPECT_NEAR(a*b,d,n*1e-15);
+    // Contiguous sub ranges still go through the kernel.
+    auto ai=a | std::views::drop(3) | std::views::take(50);
+    auto bi=b | std::views::drop(3) | std::views::take(50);
+    static_assert(matrix23::isContiguousPair<decltype(ai),decltype(bi)>);
+    d=0.0;
+    for (size_t k=3;k<53;k++) d+=a(k)*b(k);
+    EXPECT_NEAR(matrix23::inner_product(ai,bi),d,n*1e-15);
+
+    Vector<double> c=a;
+    c+=b;
+    for (size_t k=0;k<n;k++) EXPECT_EQ(c(k),a(k)+b(k));
+    c-=b;
+    for (size_t k=0;k<n;k++) EXPECT_NEAR(c(k),a(k),1e-15);
+}